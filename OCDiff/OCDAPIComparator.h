@@ -1,12 +1,38 @@
 #import <Foundation/Foundation.h>
 #import <ObjectDoc/ObjectDoc.h>
 #import "OCDAPISource.h"
+#import "OCDCursor.h"
 #import "OCDifference.h"
 
+@class OCDAPISnapshot;
+
+/**
+ * Extracts the API of a parsed source and creates snapshots of it, which are compared by OCDAPISnapshotComparator.
+ *
+ * The class also implements a comparison of the extracted cursors themselves. It is not part of this interface and
+ * is kept only as a reference that the tests check OCDAPISnapshotComparator against.
+ */
 @interface OCDAPIComparator : NSObject
 
-+ (NSArray<OCDifference *> *)differencesBetweenOldAPISource:(OCDAPISource *)oldAPISource newAPISource:(OCDAPISource *)newAPISource;
+/**
+ * Returns the declarations that make up the API of the specified source, keyed by the identifier used to match
+ * them across API versions.
+ *
+ * Extraction depends only on the source itself, so the old and new APIs may be extracted concurrently.
+ */
++ (NSDictionary<NSString *, OCDCursor *> *)APIForSource:(OCDAPISource *)source;
+
+/**
+ * Returns a snapshot of the API of the specified source.
+ *
+ * A snapshot holds everything needed to compare the API, so it can be saved and later compared via
+ * OCDAPISnapshotComparator without parsing the source again.
+ */
++ (OCDAPISnapshot *)snapshotForAPISource:(OCDAPISource *)source;
 
-+ (NSArray<OCDifference *> *)differencesBetweenOldTranslationUnit:(PLClangTranslationUnit *)oldTranslationUnit newTranslationUnit:(PLClangTranslationUnit *)newTranslationUnit;
+/**
+ * Returns a snapshot of an API that has already been extracted from the specified source via +APIForSource:.
+ */
++ (OCDAPISnapshot *)snapshotForAPISource:(OCDAPISource *)source API:(NSDictionary<NSString *, OCDCursor *> *)API;
 
 @end
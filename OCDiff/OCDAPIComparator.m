@@ -1,6 +1,7 @@
 #import "OCDAPIComparator.h"
 #import "NSString+OCDPathUtilities.h"
-#import "PLClangCursor+OCDExtensions.h"
+#import "OCDAPISnapshot.h"
+#import "OCDCursor.h"
 #import <ObjectDoc/ObjectDoc.h>
 
 @implementation OCDAPIComparator {
@@ -9,6 +10,15 @@
     NSString *_oldBaseDirectory;
     NSString *_newBaseDirectory;
 
+    /**
+     * Paths relative to the old and new base directories, keyed by absolute path.
+     *
+     * Every declaration in a header shares its path, so each is converted only once rather than once per reported
+     * difference or snapshot record.
+     */
+    NSMutableDictionary<NSString *, NSString *> *_oldRelativePaths;
+    NSMutableDictionary<NSString *, NSString *> *_newRelativePaths;
+
     /**
      * Keys for property declarations that have been converted to or from explicit accessor declarations.
      *
@@ -26,16 +36,38 @@
     _newAPISource = newAPISource;
     _oldBaseDirectory = [[oldAPISource.translationUnit.spelling stringByDeletingLastPathComponent] ocd_absolutePath];
     _newBaseDirectory = [[newAPISource.translationUnit.spelling stringByDeletingLastPathComponent] ocd_absolutePath];
+    _oldRelativePaths = [[NSMutableDictionary alloc] init];
+    _newRelativePaths = [[NSMutableDictionary alloc] init];
     _convertedProperties = [[NSMutableSet alloc] init];
 
     return self;
 }
 
+/**
+ * Compares the cursors of two API sources.
+ *
+ * This and +differencesBetweenOldTranslationUnit:newTranslationUnit: are not declared in the header. They are kept
+ * only so that the tests can check OCDAPISnapshotComparator against them.
+ */
 + (NSArray<OCDifference *> *)differencesBetweenOldAPISource:(OCDAPISource *)oldAPISource newAPISource:(OCDAPISource *)newAPISource {
     OCDAPIComparator *comparator = [[self alloc] initWithOldAPISource:oldAPISource newAPISource:newAPISource];
     return [comparator differences];
 }
 
++ (NSDictionary<NSString *, OCDCursor *> *)APIForSource:(OCDAPISource *)source {
+    OCDAPIComparator *comparator = [[self alloc] initWithOldAPISource:nil newAPISource:nil];
+    return [comparator APIForSource:source];
+}
+
++ (OCDAPISnapshot *)snapshotForAPISource:(OCDAPISource *)source {
+    return [self snapshotForAPISource:source API:[self APIForSource:source]];
+}
+
++ (OCDAPISnapshot *)snapshotForAPISource:(OCDAPISource *)source API:(NSDictionary *)API {
+    OCDAPIComparator *comparator = [[self alloc] initWithOldAPISource:nil newAPISource:source];
+    return [comparator snapshotForAPI:API];
+}
+
 + (NSArray<OCDifference *> *)differencesBetweenOldTranslationUnit:(PLClangTranslationUnit *)oldTranslationUnit newTranslationUnit:(PLClangTranslationUnit *)newTranslationUnit {
     return [self differencesBetweenOldAPISource:[OCDAPISource APISourceWithTranslationUnit:oldTranslationUnit]
                                    newAPISource:[OCDAPISource APISourceWithTranslationUnit:newTranslationUnit]];
@@ -62,65 +94,132 @@
     }
 
     for (NSString *USR in removals) {
-        PLClangCursor *cursor = oldAPI[USR];
+        OCDCursor *cursor = oldAPI[USR];
         if (cursor.isImplicit || [_convertedProperties containsObject:USR])
             continue;
 
-        NSString *relativePath = [cursor.location.path ocd_stringWithPathRelativeToDirectory:_oldBaseDirectory];
+        NSString *relativePath = [self relativePathForPath:cursor.path baseDirectory:_oldBaseDirectory relativePaths:_oldRelativePaths];
         OCDifference *difference = [OCDifference differenceWithType:OCDifferenceTypeRemoval name:[self displayNameForCursor:cursor] path:relativePath lineNumber:cursor.location.lineNumber USR:cursor.USR];
         [differences addObject:difference];
     }
 
     for (NSString *USR in additions) {
-        PLClangCursor *cursor = newAPI[USR];
+        OCDCursor *cursor = newAPI[USR];
         if (cursor.isImplicit || [_convertedProperties containsObject:USR])
             continue;
 
-        NSString *relativePath = [cursor.location.path ocd_stringWithPathRelativeToDirectory:_newBaseDirectory];
+        NSString *relativePath = [self relativePathForPath:cursor.path baseDirectory:_newBaseDirectory relativePaths:_newRelativePaths];
         OCDifference *difference = [OCDifference differenceWithType:OCDifferenceTypeAddition name:[self displayNameForCursor:cursor] path:relativePath lineNumber:cursor.location.lineNumber USR:cursor.USR];
         [differences addObject:difference];
     }
 
-    [self sortDifferences:differences];
+    [OCDifference sortDifferences:differences];
 
     return differences;
 }
 
-- (void)sortDifferences:(NSMutableArray *)differences {
-    [differences sortUsingComparator:^NSComparisonResult(OCDifference *obj1, OCDifference *obj2) {
-        NSComparisonResult result = [obj1.path localizedStandardCompare:obj2.path];
-        if (result != NSOrderedSame)
-            return result;
-
-        if (obj1.type < obj2.type) {
-            return NSOrderedAscending;
-        } else if (obj1.type > obj2.type) {
-            return NSOrderedDescending;
-        }
+/**
+ * Returns the specified path relative to a base directory, reusing a previously computed result for the same path.
+ */
+- (NSString *)relativePathForPath:(NSString *)path baseDirectory:(NSString *)baseDirectory relativePaths:(NSMutableDictionary<NSString *, NSString *> *)relativePaths {
+    if (path == nil)
+        return nil;
 
-        if (obj1.lineNumber < obj2.lineNumber) {
-            return NSOrderedAscending;
-        } else if (obj1.lineNumber > obj2.lineNumber) {
-            return NSOrderedDescending;
-        }
+    NSString *relativePath = relativePaths[path];
+    if (relativePath == nil) {
+        relativePath = [path ocd_stringWithPathRelativeToDirectory:baseDirectory];
+        relativePaths[path] = relativePath;
+    }
 
-        return [obj1.name caseInsensitiveCompare:obj2.name];
-    }];
+    return relativePath;
 }
 
 - (NSDictionary *)APIForSource:(OCDAPISource *)source {
     NSMutableDictionary *api = [NSMutableDictionary dictionary];
 
-    [source.translationUnit.cursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
-        if (source.includeSystemHeaders == NO && cursor.location.isInSystemHeader)
-            return PLClangCursorVisitContinue;
+    // Whether declarations from a file are included depends only on the file, so the decision is made once per path.
+    // In SDK mode most top-level cursors come from a small number of excluded system headers.
+    NSMutableDictionary<NSString *, NSNumber *> *includedPaths = [NSMutableDictionary dictionary];
+
+    // Relationships between Objective-C declarations are recorded from the reference cursors visited as children of
+    // each class, category, and protocol, and resolved once the visit is complete.
+    NSMutableArray<OCDCursor *> *containers = [NSMutableArray array];
+    NSMutableArray<OCDCursor *> *categories = [NSMutableArray array];
+    NSMapTable<OCDCursor *, NSMutableOrderedSet<PLClangCursor *> *> *protocolsByContainer = [NSMapTable strongToStrongObjectsMapTable];
+    __block OCDCursor *container = nil;
+    __block off_t containerEndOffset = 0;
 
-        if (cursor.location.path == nil)
+    // The location of an implicit accessor is that of the property that declared it, so properties are recorded by
+    // path and file offset, including those that are themselves excluded, and matched to accessors after the visit.
+    NSMutableDictionary<NSString *, NSMutableDictionary<NSNumber *, OCDCursor *> *> *propertiesByPath = [NSMutableDictionary dictionary];
+    NSMutableArray<OCDCursor *> *implicitAccessors = [NSMutableArray array];
+
+    [source.translationUnit.cursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *visitedCursor) {
+        OCDCursor *cursor = [OCDCursor cursorWithCursor:visitedCursor];
+        NSString *path = cursor.path;
+
+        if (path == nil)
             return PLClangCursorVisitContinue;
 
-        if (source.containingPath.length > 0 && [cursor.location.path hasPrefix:source.containingPath] == NO)
+        NSNumber *included = includedPaths[path];
+        if (included == nil) {
+            BOOL isIncluded = YES;
+
+            if (source.includeSystemHeaders == NO && cursor.location.isInSystemHeader) {
+                isIncluded = NO;
+            } else if (source.containingPath.length > 0 && [path hasPrefix:source.containingPath] == NO) {
+                isIncluded = NO;
+            }
+
+            included = @(isIncluded);
+            includedPaths[path] = included;
+        }
+
+        if ([included boolValue] == NO)
             return PLClangCursorVisitContinue;
 
+        switch (cursor.kind) {
+            case PLClangCursorKindObjCSuperclassReference:
+            case PLClangCursorKindObjCClassReference:
+            case PLClangCursorKindObjCProtocolReference:
+            {
+                // Forward declarations of classes and protocols are also visited as references, so only those within
+                // the extent of the current container belong to it.
+                if (container == nil || [path isEqualToString:container.path] == NO || cursor.location.fileOffset > containerEndOffset)
+                    return PLClangCursorVisitContinue;
+
+                PLClangCursor *referencedCursor = visitedCursor.referencedCursor ?: visitedCursor;
+                if (cursor.kind == PLClangCursorKindObjCSuperclassReference) {
+                    if (container.superclassCursor == nil) {
+                        container.superclassCursor = referencedCursor;
+                    }
+                } else if (cursor.kind == PLClangCursorKindObjCClassReference) {
+                    if (container.kind == PLClangCursorKindObjCCategoryDeclaration && container.classCursor == nil) {
+                        container.classCursor = referencedCursor;
+                    }
+                } else {
+                    [[protocolsByContainer objectForKey:container] addObject:referencedCursor];
+                }
+
+                return PLClangCursorVisitContinue;
+            }
+
+            case PLClangCursorKindObjCPropertyDeclaration:
+            {
+                NSMutableDictionary *properties = propertiesByPath[path];
+                if (properties == nil) {
+                    properties = [NSMutableDictionary dictionary];
+                    propertiesByPath[path] = properties;
+                }
+
+                properties[@(cursor.location.fileOffset)] = cursor;
+                break;
+            }
+
+            default:
+                break;
+        }
+
         if ([self shouldIncludeEntityAtCursor:cursor] == NO) {
             if (cursor.kind == PLClangCursorKindEnumDeclaration) {
                 // Enum declarations are excluded, but enum constants are included.
@@ -130,29 +229,38 @@
             }
         }
 
-        // If a category or class extension is extending a class within this
-        // module (always the case for a class extension), exclude the category
-        // declaration itself but include its childen and register the category
-        // against its class. Modifications the category makes to the class
-        // (e.g. extending protocol conformance) will then be reported as
-        // modifications of the class.
-        if (cursor.kind == PLClangCursorKindObjCCategoryDeclaration) {
-            PLClangCursor *classCursor = [self classCursorForCategoryAtCursor:cursor];
-            classCursor = classCursor ? api[[self keyForCursor:classCursor]] : nil;
-            if (classCursor != nil) {
-                [classCursor ocd_addCategory:cursor];
-                return PLClangCursorVisitRecurse;
-            }
-        }
-
         [api setObject:cursor forKey:[self keyForCursor:cursor]];
 
         switch (cursor.kind) {
             case PLClangCursorKindObjCInterfaceDeclaration:
             case PLClangCursorKindObjCCategoryDeclaration:
             case PLClangCursorKindObjCProtocolDeclaration:
+                container = cursor;
+                containerEndOffset = visitedCursor.extent.endLocation.fileOffset;
+                [containers addObject:cursor];
+                [protocolsByContainer setObject:[NSMutableOrderedSet orderedSet] forKey:cursor];
+
+                if (cursor.kind == PLClangCursorKindObjCCategoryDeclaration) {
+                    [categories addObject:cursor];
+                }
+
+                return PLClangCursorVisitRecurse;
+
             case PLClangCursorKindEnumDeclaration:
                 return PLClangCursorVisitRecurse;
+
+            case PLClangCursorKindObjCInstanceMethodDeclaration:
+            case PLClangCursorKindObjCClassMethodDeclaration:
+                if (cursor.isImplicit) {
+                    [implicitAccessors addObject:cursor];
+                }
+
+                // Fall through
+            case PLClangCursorKindObjCPropertyDeclaration:
+                // Objective-C members are only visited as children of the most recently visited container
+                cursor.container = container;
+                break;
+
             default:
                 break;
         }
@@ -160,9 +268,225 @@
         return PLClangCursorVisitContinue;
     }];
 
+    // If a category or class extension is extending a class within this
+    // module (always the case for a class extension), exclude the category
+    // declaration itself but include its childen and register the category
+    // against its class. Modifications the category makes to the class
+    // (e.g. extending protocol conformance) will then be reported as
+    // modifications of the class.
+    NSMapTable<OCDCursor *, NSMutableArray<OCDCursor *> *> *categoriesByClass = [NSMapTable strongToStrongObjectsMapTable];
+    for (OCDCursor *category in categories) {
+        OCDCursor *classEntry = category.classCursor ? api[[self keyForCursor:[OCDCursor cursorWithCursor:category.classCursor]]] : nil;
+        if (classEntry == nil)
+            continue;
+
+        NSString *key = [self keyForCursor:category];
+        if (api[key] == category) {
+            [api removeObjectForKey:key];
+        }
+
+        NSMutableArray *classCategories = [categoriesByClass objectForKey:classEntry];
+        if (classCategories == nil) {
+            classCategories = [NSMutableArray array];
+            [categoriesByClass setObject:classCategories forKey:classEntry];
+        }
+
+        [classCategories addObject:category];
+        [[protocolsByContainer objectForKey:classEntry] addObjectsFromArray:[[protocolsByContainer objectForKey:category] array]];
+    }
+
+    for (OCDCursor *classEntry in categoriesByClass) {
+        classEntry.categories = [categoriesByClass objectForKey:classEntry];
+    }
+
+    for (OCDCursor *accessor in implicitAccessors) {
+        accessor.propertyCursor = propertiesByPath[accessor.path][@(accessor.location.fileOffset)];
+    }
+
+    for (OCDCursor *entry in containers) {
+        NSMutableOrderedSet *protocols = [protocolsByContainer objectForKey:entry];
+        [protocols sortUsingComparator:^NSComparisonResult(PLClangCursor *obj1, PLClangCursor *obj2) {
+            return [obj1.spelling localizedStandardCompare:obj2.spelling];
+        }];
+        entry.protocolCursors = protocols;
+    }
+
     return api;
 }
 
+/**
+ * Returns a snapshot of an API extracted from the new API source.
+ *
+ * Each record captures the values that -differencesBetweenOldCursor:newCursor: reads from a cursor, so comparing
+ * two snapshots produces the same differences as comparing the cursors they were created from.
+ *
+ * Declaration strings are rendered for every record, including those whose headers later turn out to be unchanged.
+ * Rendering them needs the translation unit, which is released once the snapshot has been created, and which
+ * records will be reported is only known when the snapshot is compared. Display names, which need only the snapshot,
+ * are formatted when they are read.
+ */
+- (OCDAPISnapshot *)snapshotForAPI:(NSDictionary *)api {
+    PLClangTranslationUnit *translationUnit = _newAPISource.translationUnit;
+    NSString *targetPlatformName = translationUnit.targetPlatformName;
+    OCDAPISnapshotBuilder *builder = [[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:_newBaseDirectory targetPlatformName:targetPlatformName];
+
+    // Records are written in key order so that identical APIs produce identical snapshots
+    for (NSString *key in [[api allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+        @autoreleasepool {
+            OCDCursor *entry = api[key];
+            PLClangCursor *cursor = entry.cursor;
+            NSMutableArray *types = [NSMutableArray array];
+            OCDSnapshotRecord record;
+
+            // Start with every string and list reference set to OCDSnapshotNullRef
+            memset(&record, 0xFF, sizeof(record));
+
+            record.key = [builder referenceForString:key];
+            record.USR = [builder referenceForString:entry.USR];
+            record.spelling = [builder referenceForString:entry.spelling];
+
+            // Display names that are formatted from the parent name and spelling are formatted only when reported
+            switch (entry.kind) {
+                case PLClangCursorKindObjCCategoryDeclaration:
+                    record.parentName = [builder referenceForString:[self displayNameForObjCParentCursor:entry]];
+                    break;
+
+                case PLClangCursorKindObjCInstanceMethodDeclaration:
+                case PLClangCursorKindObjCClassMethodDeclaration:
+                case PLClangCursorKindObjCPropertyDeclaration:
+                    record.parentName = [builder referenceForString:[self displayNameForObjCParentCursor:entry.container]];
+                    break;
+
+                case PLClangCursorKindFunctionDeclaration:
+                case PLClangCursorKindMacroDefinition:
+                    break;
+
+                default:
+                    record.displayName = [builder referenceForString:[self displayNameForCursor:entry]];
+                    break;
+            }
+
+            record.path = [builder referenceForString:[self relativePathForPath:entry.path baseDirectory:_newBaseDirectory relativePaths:_newRelativePaths]];
+            record.lineNumber = (uint32_t)entry.location.lineNumber;
+            record.kind = (uint16_t)entry.kind;
+            record.flags = 0;
+            record.propertyAttributes = (uint32_t)cursor.objCPropertyAttributes;
+            record.availabilityKind = (uint32_t)[self availabilityKindForCursor:entry];
+            record.deprecationMessage = [builder referenceForString:[self deprecationMessageForCursor:entry targetPlatformName:targetPlatformName]];
+            record.replacement = [builder referenceForString:[self deprecationReplacementForCursor:entry targetPlatformName:targetPlatformName]];
+
+            if (entry.isImplicit) {
+                record.flags |= OCDSnapshotRecordFlagImplicit;
+            }
+
+            if (cursor.isObjCOptional) {
+                record.flags |= OCDSnapshotRecordFlagObjCOptional;
+            }
+
+            if (cursor.isVariadic) {
+                record.flags |= OCDSnapshotRecordFlagVariadic;
+            }
+
+            switch (entry.kind) {
+                case PLClangCursorKindObjCInstanceMethodDeclaration:
+                case PLClangCursorKindObjCClassMethodDeclaration:
+                {
+                    record.declaration = [builder referenceForString:[self declarationStringForCursor:cursor]];
+
+                    [types addObject:cursor.resultType.spelling ?: [NSNull null]];
+                    for (PLClangCursor *argument in cursor.arguments) {
+                        [types addObject:argument.type.spelling ?: [NSNull null]];
+                    }
+
+                    OCDCursor *propertyCursor = entry.propertyCursor;
+                    if (propertyCursor != nil) {
+                        record.propertyKey = [builder referenceForString:[self keyForCursor:propertyCursor]];
+                        record.propertyUSR = [builder referenceForString:propertyCursor.USR];
+                        record.propertyDeclaration = [builder referenceForString:[self declarationStringForCursor:propertyCursor.cursor]];
+                    }
+
+                    break;
+                }
+
+                case PLClangCursorKindObjCPropertyDeclaration:
+                {
+                    record.declaration = [builder referenceForString:[self declarationStringForCursor:cursor]];
+                    [types addObject:cursor.type.spelling ?: [NSNull null]];
+
+                    if (cursor.objCPropertyAttributes & PLClangObjCPropertyAttributeGetter) {
+                        record.getterUSR = [builder referenceForString:cursor.objCPropertyGetter.USR];
+                    }
+
+                    if (cursor.objCPropertyAttributes & PLClangObjCPropertyAttributeSetter) {
+                        record.setterUSR = [builder referenceForString:cursor.objCPropertySetter.USR];
+                    }
+
+                    break;
+                }
+
+                case PLClangCursorKindFunctionDeclaration:
+                case PLClangCursorKindVariableDeclaration:
+                {
+                    record.declaration = [builder referenceForString:[self declarationStringForCursor:cursor]];
+                    [types addObject:cursor.type.spelling ?: [NSNull null]];
+                    break;
+                }
+
+                case PLClangCursorKindTypedefDeclaration:
+                {
+                    PLClangType *underlyingType = cursor.underlyingType;
+                    record.declaration = [builder referenceForString:[self declarationStringForCursor:cursor]];
+                    [types addObject:underlyingType.spelling ?: [NSNull null]];
+
+                    if (underlyingType.kind == PLClangTypeKindBlockPointer) {
+                        record.flags |= OCDSnapshotRecordFlagBlockPointerTypedef;
+                    } else if (underlyingType.kind == PLClangTypeKindPointer && underlyingType.pointeeType.canonicalType.kind == PLClangTypeKindFunctionPrototype) {
+                        record.flags |= OCDSnapshotRecordFlagFunctionPointerTypedef;
+                    }
+
+                    break;
+                }
+
+                case PLClangCursorKindObjCInterfaceDeclaration:
+                {
+                    PLClangCursor *superclassCursor = entry.superclassCursor;
+                    if (superclassCursor != nil) {
+                        record.flags |= OCDSnapshotRecordFlagHasSuperclass;
+                        record.superclassUSR = [builder referenceForString:superclassCursor.USR];
+                        record.superclassSpelling = [builder referenceForString:superclassCursor.spelling];
+                    }
+
+                    NSMutableArray *categories = [NSMutableArray array];
+                    for (OCDCursor *categoryCursor in entry.categories) {
+                        [categories addObject:categoryCursor.spelling ?: [NSNull null]];
+                    }
+                    record.categories = [builder referenceForStrings:categories];
+
+                    break;
+                }
+
+                default:
+                    break;
+            }
+
+            record.types = [builder referenceForStrings:types];
+
+            if (entry.kind == PLClangCursorKindObjCInterfaceDeclaration || entry.kind == PLClangCursorKindObjCCategoryDeclaration || entry.kind == PLClangCursorKindObjCProtocolDeclaration) {
+                NSMutableArray *protocols = [NSMutableArray array];
+                for (PLClangCursor *protocolCursor in entry.protocolCursors) {
+                    [protocols addObject:protocolCursor.USR ?: [NSNull null]];
+                    [protocols addObject:protocolCursor.spelling ?: @""];
+                }
+                record.protocols = [builder referenceForStrings:protocols];
+            }
+
+            [builder addRecord:&record];
+        }
+    }
+
+    return [builder snapshot];
+}
+
 /**
  * Returns a key suitable for identifying the specified cursor across translation units.
  *
@@ -171,7 +495,7 @@
  * moving the declaration to a different file or line number would be detected as a removal and addition. As a result
  * a custom key is generated in place of the USR for these declarations.
  */
-- (NSString *)keyForCursor:(PLClangCursor *)cursor {
+- (NSString *)keyForCursor:(OCDCursor *)cursor {
     NSString *prefix = nil;
 
     switch (cursor.kind) {
@@ -210,7 +534,7 @@
  * the only cursors that will have a cursor kind of Objective-C class or protocol, it is safe to special-case them to
  * always be considered canonical.
  */
-- (BOOL)isCanonicalCursor:(PLClangCursor *)cursor {
+- (BOOL)isCanonicalCursor:(OCDCursor *)cursor {
     switch (cursor.kind) {
         case PLClangCursorKindObjCInterfaceDeclaration:
         case PLClangCursorKindObjCCategoryDeclaration:
@@ -218,7 +542,7 @@
             return YES;
         default:
         {
-            BOOL isCanonical = [cursor.canonicalCursor isEqual:cursor];
+            BOOL isCanonical = [cursor.canonicalCursor isEqual:cursor.cursor];
             if (isCanonical == NO && cursor.kind == PLClangCursorKindFunctionDeclaration) {
                 // TODO: Clang has an issue with declarations for functions that exist in its builtin function database
                 // (e.g., NSLog, objc_msgSend). The canonical cursor for these functions has an identical source
@@ -236,7 +560,7 @@
 /**
  * Returns a Boolean value indicating whether the entity at the specified cursor should be included in the API.
  */
-- (BOOL)shouldIncludeEntityAtCursor:(PLClangCursor *)cursor {
+- (BOOL)shouldIncludeEntityAtCursor:(OCDCursor *)cursor {
     if ((cursor.isDeclaration && [self shouldIncludeDeclarationAtCursor:cursor]) ||
         (cursor.kind == PLClangCursorKindMacroDefinition && [self shouldIncludeMacroDefinitionAtCursor:cursor])) {
         // Exclude private APIs indicated by name
@@ -258,7 +582,7 @@
 /**
  * Returns a Boolean value indicating whether the declaration at the specified cursor should be included in the API.
  */
-- (BOOL)shouldIncludeDeclarationAtCursor:(PLClangCursor *)cursor {
+- (BOOL)shouldIncludeDeclarationAtCursor:(OCDCursor *)cursor {
     if ([self isCanonicalCursor:cursor] == NO) {
         return NO;
     }
@@ -294,7 +618,7 @@
 /**
  * Returns a Boolean value indicating whether the macro definition at the specified cursor should be included in the API.
  */
-- (BOOL)shouldIncludeMacroDefinitionAtCursor:(PLClangCursor *)cursor {
+- (BOOL)shouldIncludeMacroDefinitionAtCursor:(OCDCursor *)cursor {
     if ([self isEmptyMacroDefinitionAtCursor:cursor]) {
         return NO;
     }
@@ -307,18 +631,19 @@
  *
  * An empty definition can be identified by an extent that includes only the macro's spelling.
  */
-- (BOOL)isEmptyMacroDefinitionAtCursor:(PLClangCursor *)cursor {
+- (BOOL)isEmptyMacroDefinitionAtCursor:(OCDCursor *)cursor {
     if (cursor.kind != PLClangCursorKindMacroDefinition)
         return NO;
 
-    if (cursor.extent.startLocation.lineNumber != cursor.extent.endLocation.lineNumber)
+    PLClangSourceRange *extent = cursor.cursor.extent;
+    if (extent.startLocation.lineNumber != extent.endLocation.lineNumber)
         return NO;
 
-    NSUInteger extentLength = cursor.extent.endLocation.columnNumber - cursor.extent.startLocation.columnNumber;
+    NSUInteger extentLength = extent.endLocation.columnNumber - extent.startLocation.columnNumber;
     return extentLength == [cursor.spelling length];
 }
 
-- (NSArray *)differencesBetweenOldCursor:(PLClangCursor *)oldCursor newCursor:(PLClangCursor *)newCursor {
+- (NSArray *)differencesBetweenOldCursor:(OCDCursor *)oldCursor newCursor:(OCDCursor *)newCursor {
     NSMutableArray *modifications = [NSMutableArray array];
     NSString *newUSR = newCursor.USR;
 
@@ -332,21 +657,21 @@
         // difference - the methods have not been added or removed, only their declaration has changed.
         NSString *oldDeclaration;
         NSString *newDeclaration;
-        PLClangCursor *propertyCursor;
+        OCDCursor *propertyCursor;
 
         if (newCursor.isImplicit) {
-            propertyCursor = [_newAPISource.translationUnit cursorForSourceLocation:newCursor.location];
+            propertyCursor = newCursor.propertyCursor;
             NSAssert(propertyCursor != nil, @"Failed to locate property cursor for conversion from explicit accessor");
 
-            oldDeclaration = [self declarationStringForCursor:oldCursor];
-            newDeclaration = [self declarationStringForCursor:propertyCursor];
+            oldDeclaration = [self declarationStringForCursor:oldCursor.cursor];
+            newDeclaration = [self declarationStringForCursor:propertyCursor.cursor];
             newUSR = propertyCursor.USR;
         } else {
-            propertyCursor = [_oldAPISource.translationUnit cursorForSourceLocation:oldCursor.location];
+            propertyCursor = oldCursor.propertyCursor;
             NSAssert(propertyCursor != nil, @"Failed to locate property cursor for conversion to explicit accessor");
 
-            oldDeclaration = [self declarationStringForCursor:propertyCursor];
-            newDeclaration = [self declarationStringForCursor:newCursor];
+            oldDeclaration = [self declarationStringForCursor:propertyCursor.cursor];
+            newDeclaration = [self declarationStringForCursor:newCursor.cursor];
         }
 
         [_convertedProperties addObject:[self keyForCursor:propertyCursor]];
@@ -355,16 +680,16 @@
                                                                 previousValue:oldDeclaration
                                                                  currentValue:newDeclaration];
         [modifications addObject:modification];
-    } else if ([self declarationChangedBetweenOldCursor:oldCursor newCursor:newCursor]) {
+    } else if ([self declarationChangedBetweenOldCursor:oldCursor.cursor newCursor:newCursor.cursor]) {
         OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
-                                                                previousValue:[self declarationStringForCursor:oldCursor]
-                                                                 currentValue:[self declarationStringForCursor:newCursor]];
+                                                                previousValue:[self declarationStringForCursor:oldCursor.cursor]
+                                                                 currentValue:[self declarationStringForCursor:newCursor.cursor]];
         [modifications addObject:modification];
     }
 
     if (oldCursor.kind == PLClangCursorKindObjCInterfaceDeclaration) {
-        PLClangCursor *oldSuperclass = [self superclassCursorForClassAtCursor:oldCursor];
-        PLClangCursor *newSuperclass = [self superclassCursorForClassAtCursor:newCursor];
+        PLClangCursor *oldSuperclass = oldCursor.superclassCursor;
+        PLClangCursor *newSuperclass = newCursor.superclassCursor;
         if (oldSuperclass != newSuperclass && [oldSuperclass.USR isEqual:newSuperclass.USR] == NO) {
             OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeSuperclass
                                                                     previousValue:oldSuperclass.spelling
@@ -374,8 +699,8 @@
     }
 
     if (oldCursor.kind == PLClangCursorKindObjCInterfaceDeclaration || oldCursor.kind == PLClangCursorKindObjCCategoryDeclaration || oldCursor.kind == PLClangCursorKindObjCProtocolDeclaration) {
-        NSOrderedSet *oldProtocols = [self protocolCursorsForCursor:oldCursor];
-        NSOrderedSet *newProtocols = [self protocolCursorsForCursor:newCursor];
+        NSOrderedSet *oldProtocols = oldCursor.protocolCursors;
+        NSOrderedSet *newProtocols = newCursor.protocolCursors;
         BOOL protocolsChanged = NO;
         if ([oldProtocols count] != [newProtocols count]) {
             protocolsChanged = YES;
@@ -398,10 +723,10 @@
         }
     }
 
-    if (oldCursor.isObjCOptional != newCursor.isObjCOptional) {
+    if (oldCursor.cursor.isObjCOptional != newCursor.cursor.isObjCOptional) {
         OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeOptional
-                                                                previousValue:oldCursor.isObjCOptional ? @"Optional" : @"Required"
-                                                                 currentValue:newCursor.isObjCOptional ? @"Optional" : @"Required"];
+                                                                previousValue:oldCursor.cursor.isObjCOptional ? @"Optional" : @"Required"
+                                                                 currentValue:newCursor.cursor.isObjCOptional ? @"Optional" : @"Required"];
         [modifications addObject:modification];
     }
 
@@ -413,18 +738,9 @@
                                                                  currentValue:[self stringForAvailabilityKind:newAvailabilityKind]];
         [modifications addObject:modification];
 
-        PLClangPlatformAvailability *newPlatformAvailability = [self platformAvailabilityForCursor:newCursor
-                                                                                targetPlatformName:_newAPISource.translationUnit.targetPlatformName];
-
-        NSString *deprecationMessage = newCursor.availability.unconditionalDeprecationMessage;
-        if ([deprecationMessage length] == 0 && newPlatformAvailability != nil) {
-            deprecationMessage = newPlatformAvailability.message;
-        }
-
-        NSString *replacement = newCursor.availability.unconditionalDeprecationReplacement;
-        if ([replacement length] == 0 && newPlatformAvailability != nil) {
-            replacement = newPlatformAvailability.replacement;
-        }
+        NSString *targetPlatformName = _newAPISource.translationUnit.targetPlatformName;
+        NSString *deprecationMessage = [self deprecationMessageForCursor:newCursor targetPlatformName:targetPlatformName];
+        NSString *replacement = [self deprecationReplacementForCursor:newCursor targetPlatformName:targetPlatformName];
 
         if (newAvailabilityKind == PLClangAvailabilityKindDeprecated && [deprecationMessage length] > 0) {
             modification = [OCDModification modificationWithType:OCDModificationTypeDeprecationMessage
@@ -443,7 +759,7 @@
         NSMutableArray *differences = [NSMutableArray array];
         OCDifference *difference;
 
-        NSString *relativePath = [newCursor.location.path ocd_stringWithPathRelativeToDirectory:_newBaseDirectory];
+        NSString *relativePath = [self relativePathForPath:newCursor.path baseDirectory:_newBaseDirectory relativePaths:_newRelativePaths];
         difference = [OCDifference modificationDifferenceWithName:[self displayNameForCursor:oldCursor]
                                                              path:relativePath
                                                        lineNumber:newCursor.location.lineNumber
@@ -457,55 +773,6 @@
     return nil;
 }
 
-- (PLClangCursor *)superclassCursorForClassAtCursor:(PLClangCursor *)classCursor {
-    __block PLClangCursor *superclassCursor = nil;
-    [classCursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
-        if (cursor.kind == PLClangCursorKindObjCSuperclassReference) {
-            superclassCursor = cursor.referencedCursor ?: cursor;
-            return PLClangCursorVisitBreak;
-        }
-
-        return PLClangCursorVisitContinue;
-    }];
-
-    return superclassCursor;
-}
-
-- (PLClangCursor *)classCursorForCategoryAtCursor:(PLClangCursor *)categoryCursor {
-    __block PLClangCursor *classCursor = nil;
-    [categoryCursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
-        if (cursor.kind == PLClangCursorKindObjCClassReference) {
-            classCursor = cursor.referencedCursor ?: cursor;
-            return PLClangCursorVisitBreak;
-        }
-
-        return PLClangCursorVisitContinue;
-    }];
-
-    return classCursor;
-}
-
-- (NSOrderedSet *)protocolCursorsForCursor:(PLClangCursor *)classCursor {
-    NSMutableOrderedSet *protocols = [NSMutableOrderedSet orderedSet];
-    [classCursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
-        if (cursor.kind == PLClangCursorKindObjCProtocolReference) {
-            [protocols addObject:cursor.referencedCursor ?: cursor];
-        }
-
-        return PLClangCursorVisitContinue;
-    }];
-
-    for (PLClangCursor *categoryCursor in classCursor.ocd_categories) {
-        [protocols addObjectsFromArray:[self protocolCursorsForCursor:categoryCursor].array];
-    }
-
-    [protocols sortUsingComparator:^NSComparisonResult(PLClangCursor *obj1, PLClangCursor *obj2) {
-        return [obj1.spelling localizedStandardCompare:obj2.spelling];
-    }];
-
-    return protocols;
-}
-
 - (BOOL)declarationChangedBetweenOldCursor:(PLClangCursor *)oldCursor newCursor:(PLClangCursor *)newCursor {
     switch (oldCursor.kind) {
         case PLClangCursorKindObjCInstanceMethodDeclaration:
@@ -912,27 +1179,27 @@
     }
 }
 
-- (NSString *)displayNameForObjCParentCursor:(PLClangCursor *)cursor {
+- (NSString *)displayNameForObjCParentCursor:(OCDCursor *)cursor {
     if (cursor.kind == PLClangCursorKindObjCCategoryDeclaration) {
-        return [self classCursorForCategoryAtCursor:cursor].spelling;
+        return cursor.classCursor.spelling;
     }
 
     return cursor.spelling;
 }
 
-- (NSString *)displayNameForCursor:(PLClangCursor *)cursor {
+- (NSString *)displayNameForCursor:(OCDCursor *)cursor {
     switch (cursor.kind) {
         case PLClangCursorKindObjCCategoryDeclaration:
             return [NSString stringWithFormat:@"%@ (%@)", [self displayNameForObjCParentCursor:cursor], cursor.spelling];
 
         case PLClangCursorKindObjCInstanceMethodDeclaration:
-            return [NSString stringWithFormat:@"-[%@ %@]", [self displayNameForObjCParentCursor:cursor.semanticParent], cursor.spelling];
+            return [NSString stringWithFormat:@"-[%@ %@]", [self displayNameForObjCParentCursor:cursor.container], cursor.spelling];
 
         case PLClangCursorKindObjCClassMethodDeclaration:
-            return [NSString stringWithFormat:@"+[%@ %@]", [self displayNameForObjCParentCursor:cursor.semanticParent], cursor.spelling];
+            return [NSString stringWithFormat:@"+[%@ %@]", [self displayNameForObjCParentCursor:cursor.container], cursor.spelling];
 
         case PLClangCursorKindObjCPropertyDeclaration:
-            return [NSString stringWithFormat:@"%@.%@", [self displayNameForObjCParentCursor:cursor.semanticParent], cursor.spelling];
+            return [NSString stringWithFormat:@"%@.%@", [self displayNameForObjCParentCursor:cursor.container], cursor.spelling];
 
         case PLClangCursorKindFunctionDeclaration:
             return [NSString stringWithFormat:@"%@()", cursor.spelling];
@@ -941,7 +1208,7 @@
             return [NSString stringWithFormat:@"#def %@", cursor.spelling];
 
         default:
-            return cursor.displayName;
+            return cursor.cursor.displayName;
     }
 }
 
@@ -980,7 +1247,7 @@
  * attribute for. Old SDKs also used this method to document deprecated methods prior to the introduction of
  * availability attributes.
  */
-- (PLClangAvailabilityKind)availabilityKindForCursor:(PLClangCursor *)cursor {
+- (PLClangAvailabilityKind)availabilityKindForCursor:(OCDCursor *)cursor {
     PLClangAvailabilityKind availabilityKind = cursor.availability.kind;
     if (availabilityKind == PLClangAvailabilityKindAvailable) {
         switch (cursor.kind) {
@@ -1005,7 +1272,25 @@
     return availabilityKind;
 }
 
-- (PLClangPlatformAvailability *)platformAvailabilityForCursor:(PLClangCursor *)cursor targetPlatformName:(NSString *)targetPlatformName {
+- (NSString *)deprecationMessageForCursor:(OCDCursor *)cursor targetPlatformName:(NSString *)targetPlatformName {
+    NSString *deprecationMessage = cursor.availability.unconditionalDeprecationMessage;
+    if ([deprecationMessage length] == 0) {
+        deprecationMessage = [self platformAvailabilityForCursor:cursor targetPlatformName:targetPlatformName].message;
+    }
+
+    return deprecationMessage;
+}
+
+- (NSString *)deprecationReplacementForCursor:(OCDCursor *)cursor targetPlatformName:(NSString *)targetPlatformName {
+    NSString *replacement = cursor.availability.unconditionalDeprecationReplacement;
+    if ([replacement length] == 0) {
+        replacement = [self platformAvailabilityForCursor:cursor targetPlatformName:targetPlatformName].replacement;
+    }
+
+    return replacement;
+}
+
+- (PLClangPlatformAvailability *)platformAvailabilityForCursor:(OCDCursor *)cursor targetPlatformName:(NSString *)targetPlatformName {
     for (PLClangPlatformAvailability *availability in cursor.availability.platformAvailabilityEntries) {
         if ([availability.platformName isEqualToString:targetPlatformName]) {
             return availability;
@@ -0,0 +1,198 @@
+#import <Foundation/Foundation.h>
+#import "OCDStringTable.h"
+
+/**
+ * The version of the snapshot format written by this version of the tool.
+ *
+ * Snapshots written with any other version are rejected when loaded.
+ */
+extern const uint32_t OCDAPISnapshotVersion;
+
+/**
+ * A reference to a string in a snapshot's string table.
+ *
+ * Strings are deduplicated when a snapshot is written, so two references within the same snapshot are equal if and
+ * only if the strings they refer to are equal.
+ */
+typedef uint32_t OCDSnapshotStringRef;
+
+/**
+ * A reference to a list of string references in a snapshot's list table.
+ */
+typedef uint32_t OCDSnapshotListRef;
+
+/**
+ * The reference used for nil strings and empty lists.
+ */
+#define OCDSnapshotNullRef UINT32_MAX
+
+/**
+ * The fingerprint of a record that must always be compared in detail.
+ */
+#define OCDSnapshotNoFingerprint 0
+
+typedef NS_OPTIONS(uint16_t, OCDSnapshotRecordFlags) {
+    OCDSnapshotRecordFlagImplicit               = 1 << 0,
+    OCDSnapshotRecordFlagObjCOptional           = 1 << 1,
+    OCDSnapshotRecordFlagVariadic               = 1 << 2,
+    OCDSnapshotRecordFlagHasSuperclass          = 1 << 3,
+    OCDSnapshotRecordFlagBlockPointerTypedef    = 1 << 4,
+    OCDSnapshotRecordFlagFunctionPointerTypedef = 1 << 5
+};
+
+/**
+ * A declaration in an API snapshot.
+ *
+ * A record holds every value the comparator reads from a declaration's cursor. Values that the comparator derives
+ * from other cursors, such as the parent name, declaration string, and protocol conformances, are resolved when
+ * the snapshot is written so that no translation unit is needed to compare it.
+ */
+typedef struct {
+    /**
+     * A hash of the key and of every value the comparator examines to detect a modification, computed by the
+     * builder when the record is added.
+     *
+     * Two records with the same key and the same fingerprint have no differences, so they need not be compared in
+     * detail. Records whose comparison never considers them equal, such as a property with a custom getter whose
+     * USR is unknown, have a fingerprint of OCDSnapshotNoFingerprint.
+     */
+    uint64_t fingerprint;
+
+    OCDSnapshotStringRef key;
+    OCDSnapshotStringRef USR;
+    OCDSnapshotStringRef spelling;
+
+    /**
+     * The display name, for kinds of declarations whose display name is not formatted from the parent name and
+     * spelling by -[OCDAPISnapshot displayNameForRecord:].
+     */
+    OCDSnapshotStringRef displayName;
+
+    /** For an Objective-C method, property, or category, the name of the class or protocol it belongs to. */
+    OCDSnapshotStringRef parentName;
+
+    /** The declaration string, for kinds of declarations that have one. */
+    OCDSnapshotStringRef declaration;
+
+    /** The path of the declaration's header, relative to the snapshot's base directory. */
+    OCDSnapshotStringRef path;
+    uint32_t lineNumber;
+
+    /** The PLClangCursorKind of the declaration. */
+    uint16_t kind;
+    OCDSnapshotRecordFlags flags;
+    uint32_t propertyAttributes;
+
+    /** The PLClangAvailabilityKind of the declaration, including deprecation via a "Deprecated" category. */
+    uint32_t availabilityKind;
+    OCDSnapshotStringRef deprecationMessage;
+    OCDSnapshotStringRef replacement;
+
+    /**
+     * Spellings of the types that make up the declaration: the result type followed by the argument types for
+     * methods, the type of a property, function, or variable, or the underlying type of a typedef. A type without a
+     * spelling is stored as OCDSnapshotNullRef and, as in OCDAPIComparator, is unequal to every type.
+     */
+    OCDSnapshotListRef types;
+
+    /** Alternating USRs and spellings of the protocols the declaration conforms to, including via categories. */
+    OCDSnapshotListRef protocols;
+
+    OCDSnapshotStringRef superclassUSR;
+    OCDSnapshotStringRef superclassSpelling;
+
+    /** Spellings of the categories of a class that have been merged into the class. */
+    OCDSnapshotListRef categories;
+
+    OCDSnapshotStringRef getterUSR;
+    OCDSnapshotStringRef setterUSR;
+
+    /** For an implicit property accessor, the key, USR, and declaration string of its property. */
+    OCDSnapshotStringRef propertyKey;
+    OCDSnapshotStringRef propertyUSR;
+    OCDSnapshotStringRef propertyDeclaration;
+} OCDSnapshotRecord;
+
+/**
+ * An immutable snapshot of an extracted API.
+ *
+ * A snapshot is a single little-endian buffer containing a header, a table of fixed-size records, a list table, and
+ * a string table. Loading a snapshot from a file maps it into memory and validates every reference within it; no
+ * other parsing is performed.
+ */
+@interface OCDAPISnapshot : NSObject
+
++ (instancetype)snapshotWithContentsOfFile:(NSString *)path error:(NSError **)error;
++ (instancetype)snapshotWithData:(NSData *)data error:(NSError **)error;
+
+- (BOOL)writeToFile:(NSString *)path error:(NSError **)error;
+
+@property (nonatomic, readonly) NSData *data;
+
+/**
+ * The directory that record paths are relative to.
+ */
+@property (nonatomic, readonly) NSString *baseDirectory;
+
+/**
+ * The name of the platform that the API was parsed for.
+ */
+@property (nonatomic, readonly) NSString *targetPlatformName;
+
+@property (nonatomic, readonly) NSUInteger recordCount;
+@property (nonatomic, readonly) const OCDSnapshotRecord *records;
+
+/**
+ * Returns the string for the specified reference, or nil for OCDSnapshotNullRef.
+ */
+- (NSString *)stringForReference:(OCDSnapshotStringRef)reference;
+
+/**
+ * Returns the display name of the specified record.
+ *
+ * Display names of Objective-C members and categories, functions, and macros are formatted from the record's kind,
+ * parent name, and spelling each time they are requested rather than when the snapshot is written, as only the
+ * records that are reported need one.
+ */
+- (NSString *)displayNameForRecord:(const OCDSnapshotRecord *)record;
+
+/**
+ * Returns the elements of the list for the specified reference.
+ *
+ * @param count On return, the number of elements in the list. This is zero for OCDSnapshotNullRef.
+ */
+- (const OCDSnapshotStringRef *)elementsOfList:(OCDSnapshotListRef)reference count:(NSUInteger *)count;
+
+/**
+ * Interns every string referenced by the snapshot's records in the specified table.
+ *
+ * The returned data holds an OCDStringID for each four bytes of the snapshot's string table, so that the identifier
+ * for a reference other than OCDSnapshotNullRef is at index reference / 4. Strings from several snapshots interned
+ * in the same table may then be compared by identifier.
+ */
+- (NSData *)identifiersForStringsInTable:(OCDStringTable *)table;
+
+@end
+
+/**
+ * Accumulates records for a new API snapshot.
+ */
+@interface OCDAPISnapshotBuilder : NSObject
+
+- (instancetype)initWithBaseDirectory:(NSString *)baseDirectory targetPlatformName:(NSString *)targetPlatformName;
+
+/**
+ * Returns a reference to the specified string, adding it to the string table if necessary.
+ */
+- (OCDSnapshotStringRef)referenceForString:(NSString *)string;
+
+/**
+ * Returns a reference to a list of the specified strings. NSNull elements are stored as OCDSnapshotNullRef.
+ */
+- (OCDSnapshotListRef)referenceForStrings:(NSArray *)strings;
+
+- (void)addRecord:(const OCDSnapshotRecord *)record;
+
+- (OCDAPISnapshot *)snapshot;
+
+@end
@@ -0,0 +1,468 @@
+#import "OCDAPISnapshot.h"
+#import <ObjectDoc/ObjectDoc.h>
+#import "OCDHash.h"
+
+const uint32_t OCDAPISnapshotVersion = 3;
+
+/** The magic number at the start of every snapshot, "OCDS" when read as bytes. */
+static const uint32_t OCDSnapshotMagic = 0x5344434F;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t recordCount;
+    uint32_t recordsOffset;
+    uint32_t listsOffset;
+    uint32_t listsCount;
+    uint32_t stringsOffset;
+    uint32_t stringsLength;
+    OCDSnapshotStringRef baseDirectory;
+    OCDSnapshotStringRef targetPlatformName;
+
+    /** Pads the header so that records are 8-byte aligned. */
+    uint32_t reserved;
+} OCDSnapshotHeader;
+
+static const size_t OCDSnapshotRecordStringFields[] = {
+    offsetof(OCDSnapshotRecord, key),
+    offsetof(OCDSnapshotRecord, USR),
+    offsetof(OCDSnapshotRecord, spelling),
+    offsetof(OCDSnapshotRecord, displayName),
+    offsetof(OCDSnapshotRecord, parentName),
+    offsetof(OCDSnapshotRecord, declaration),
+    offsetof(OCDSnapshotRecord, path),
+    offsetof(OCDSnapshotRecord, deprecationMessage),
+    offsetof(OCDSnapshotRecord, replacement),
+    offsetof(OCDSnapshotRecord, superclassUSR),
+    offsetof(OCDSnapshotRecord, superclassSpelling),
+    offsetof(OCDSnapshotRecord, getterUSR),
+    offsetof(OCDSnapshotRecord, setterUSR),
+    offsetof(OCDSnapshotRecord, propertyKey),
+    offsetof(OCDSnapshotRecord, propertyUSR),
+    offsetof(OCDSnapshotRecord, propertyDeclaration)
+};
+
+static const size_t OCDSnapshotRecordListFields[] = {
+    offsetof(OCDSnapshotRecord, types),
+    offsetof(OCDSnapshotRecord, protocols),
+    offsetof(OCDSnapshotRecord, categories)
+};
+
+static NSError *OCDSnapshotError(NSString *description) {
+    return [NSError errorWithDomain:NSCocoaErrorDomain
+                               code:NSFileReadCorruptFileError
+                           userInfo:@{NSLocalizedDescriptionKey: description}];
+}
+
+static uint32_t OCDSnapshotRecordField(const OCDSnapshotRecord *record, size_t offset) {
+    return *(const uint32_t *)((const uint8_t *)record + offset);
+}
+
+@implementation OCDAPISnapshot {
+    const OCDSnapshotHeader *_header;
+    const uint32_t *_lists;
+    const uint8_t *_strings;
+}
+
++ (instancetype)snapshotWithContentsOfFile:(NSString *)path error:(NSError **)error {
+    NSData *data = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:error];
+    if (data == nil) {
+        return nil;
+    }
+
+    return [self snapshotWithData:data error:error];
+}
+
++ (instancetype)snapshotWithData:(NSData *)data error:(NSError **)error {
+    return [[self alloc] initWithData:data error:error];
+}
+
+- (instancetype)initWithData:(NSData *)data error:(NSError **)error {
+    if (!(self = [super init]))
+        return nil;
+
+    NSError *validationError = nil;
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    const OCDSnapshotHeader *header = (const OCDSnapshotHeader *)bytes;
+
+    if (length < sizeof(OCDSnapshotHeader) || header->magic != OCDSnapshotMagic) {
+        validationError = OCDSnapshotError(@"The file is not an API snapshot.");
+    } else if (header->version != OCDAPISnapshotVersion || header->recordSize != sizeof(OCDSnapshotRecord)) {
+        validationError = OCDSnapshotError([NSString stringWithFormat:@"The API snapshot has version %u, but only version %u is supported.",
+                                            header->version, OCDAPISnapshotVersion]);
+    } else if ((uint64_t)header->recordsOffset + (uint64_t)header->recordCount * sizeof(OCDSnapshotRecord) > length ||
+               (uint64_t)header->listsOffset + (uint64_t)header->listsCount * sizeof(uint32_t) > length ||
+               (uint64_t)header->stringsOffset + header->stringsLength > length ||
+               header->recordsOffset % sizeof(uint64_t) != 0 ||
+               header->listsOffset % sizeof(uint32_t) != 0 ||
+               header->stringsOffset % sizeof(uint32_t) != 0) {
+        validationError = OCDSnapshotError(@"The API snapshot is truncated.");
+    }
+
+    if (validationError == nil) {
+        _data = data;
+        _header = header;
+        _records = (const OCDSnapshotRecord *)(bytes + header->recordsOffset);
+        _recordCount = header->recordCount;
+        _lists = (const uint32_t *)(bytes + header->listsOffset);
+        _strings = bytes + header->stringsOffset;
+
+        if ([self validateReferences] == NO) {
+            validationError = OCDSnapshotError(@"The API snapshot is corrupt.");
+        }
+    }
+
+    if (validationError != nil) {
+        if (error != NULL) {
+            *error = validationError;
+        }
+
+        return nil;
+    }
+
+    _baseDirectory = [self stringForReference:header->baseDirectory];
+    _targetPlatformName = [self stringForReference:header->targetPlatformName];
+
+    return self;
+}
+
+/**
+ * Returns a Boolean value indicating whether every reference in the snapshot is within bounds, so that records
+ * may subsequently be read without any checks.
+ */
+- (BOOL)validateReferences {
+    if (![self isValidStringReference:_header->baseDirectory] || ![self isValidStringReference:_header->targetPlatformName]) {
+        return NO;
+    }
+
+    for (NSUInteger recordIndex = 0; recordIndex < _recordCount; recordIndex++) {
+        const OCDSnapshotRecord *record = &_records[recordIndex];
+
+        for (size_t i = 0; i < sizeof(OCDSnapshotRecordStringFields) / sizeof(OCDSnapshotRecordStringFields[0]); i++) {
+            if (![self isValidStringReference:OCDSnapshotRecordField(record, OCDSnapshotRecordStringFields[i])]) {
+                return NO;
+            }
+        }
+
+        for (size_t i = 0; i < sizeof(OCDSnapshotRecordListFields) / sizeof(OCDSnapshotRecordListFields[0]); i++) {
+            if (![self isValidListReference:OCDSnapshotRecordField(record, OCDSnapshotRecordListFields[i])]) {
+                return NO;
+            }
+        }
+    }
+
+    return YES;
+}
+
+- (BOOL)isValidStringReference:(OCDSnapshotStringRef)reference {
+    if (reference == OCDSnapshotNullRef) {
+        return YES;
+    }
+
+    uint64_t stringsLength = _header->stringsLength;
+    if (reference % sizeof(uint32_t) != 0 || (uint64_t)reference + sizeof(uint32_t) > stringsLength) {
+        return NO;
+    }
+
+    uint32_t length = *(const uint32_t *)(_strings + reference);
+    uint64_t terminator = (uint64_t)reference + sizeof(uint32_t) + length;
+    return terminator < stringsLength && _strings[terminator] == '\0';
+}
+
+- (BOOL)isValidListReference:(OCDSnapshotListRef)reference {
+    if (reference == OCDSnapshotNullRef) {
+        return YES;
+    }
+
+    if (reference >= _header->listsCount) {
+        return NO;
+    }
+
+    uint32_t count = _lists[reference];
+    if ((uint64_t)reference + 1 + count > _header->listsCount) {
+        return NO;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (![self isValidStringReference:_lists[reference + 1 + i]]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (NSData *)identifiersForStringsInTable:(OCDStringTable *)table {
+    NSUInteger identifierCount = _header->stringsLength / sizeof(uint32_t);
+    NSMutableData *data = [NSMutableData dataWithLength:identifierCount * sizeof(OCDStringID)];
+    OCDStringID *identifiers = [data mutableBytes];
+    memset(identifiers, 0xFF, [data length]);
+
+    // Strings are usually referenced by many records, so each is interned only the first time it is seen
+    void (^internString)(OCDSnapshotStringRef) = ^(OCDSnapshotStringRef reference) {
+        if (reference != OCDSnapshotNullRef && identifiers[reference / sizeof(uint32_t)] == UINT32_MAX) {
+            uint32_t length = *(const uint32_t *)(_strings + reference);
+            identifiers[reference / sizeof(uint32_t)] = [table identifierForUTF8String:(const char *)_strings + reference + sizeof(uint32_t) length:length];
+        }
+    };
+
+    for (NSUInteger recordIndex = 0; recordIndex < _recordCount; recordIndex++) {
+        const OCDSnapshotRecord *record = &_records[recordIndex];
+
+        for (size_t i = 0; i < sizeof(OCDSnapshotRecordStringFields) / sizeof(OCDSnapshotRecordStringFields[0]); i++) {
+            internString(OCDSnapshotRecordField(record, OCDSnapshotRecordStringFields[i]));
+        }
+
+        for (size_t i = 0; i < sizeof(OCDSnapshotRecordListFields) / sizeof(OCDSnapshotRecordListFields[0]); i++) {
+            NSUInteger count;
+            const OCDSnapshotStringRef *elements = [self elementsOfList:OCDSnapshotRecordField(record, OCDSnapshotRecordListFields[i]) count:&count];
+            for (NSUInteger elementIndex = 0; elementIndex < count; elementIndex++) {
+                internString(elements[elementIndex]);
+            }
+        }
+    }
+
+    return data;
+}
+
+- (BOOL)writeToFile:(NSString *)path error:(NSError **)error {
+    return [_data writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
+- (NSString *)stringForReference:(OCDSnapshotStringRef)reference {
+    if (reference == OCDSnapshotNullRef) {
+        return nil;
+    }
+
+    uint32_t length = *(const uint32_t *)(_strings + reference);
+    return [[NSString alloc] initWithBytes:_strings + reference + sizeof(uint32_t) length:length encoding:NSUTF8StringEncoding];
+}
+
+- (NSString *)displayNameForRecord:(const OCDSnapshotRecord *)record {
+    switch (record->kind) {
+        case PLClangCursorKindObjCCategoryDeclaration:
+            return [NSString stringWithFormat:@"%@ (%@)", [self stringForReference:record->parentName], [self stringForReference:record->spelling]];
+
+        case PLClangCursorKindObjCInstanceMethodDeclaration:
+            return [NSString stringWithFormat:@"-[%@ %@]", [self stringForReference:record->parentName], [self stringForReference:record->spelling]];
+
+        case PLClangCursorKindObjCClassMethodDeclaration:
+            return [NSString stringWithFormat:@"+[%@ %@]", [self stringForReference:record->parentName], [self stringForReference:record->spelling]];
+
+        case PLClangCursorKindObjCPropertyDeclaration:
+            return [NSString stringWithFormat:@"%@.%@", [self stringForReference:record->parentName], [self stringForReference:record->spelling]];
+
+        case PLClangCursorKindFunctionDeclaration:
+            return [NSString stringWithFormat:@"%@()", [self stringForReference:record->spelling]];
+
+        case PLClangCursorKindMacroDefinition:
+            return [NSString stringWithFormat:@"#def %@", [self stringForReference:record->spelling]];
+
+        default:
+            return [self stringForReference:record->displayName];
+    }
+}
+
+- (const OCDSnapshotStringRef *)elementsOfList:(OCDSnapshotListRef)reference count:(NSUInteger *)count {
+    if (reference == OCDSnapshotNullRef) {
+        *count = 0;
+        return NULL;
+    }
+
+    *count = _lists[reference];
+    return &_lists[reference + 1];
+}
+
+@end
+
+@implementation OCDAPISnapshotBuilder {
+    NSMutableData *_records;
+    NSUInteger _recordCount;
+    NSMutableData *_lists;
+    NSMutableData *_strings;
+    NSMutableDictionary<NSString *, NSNumber *> *_stringReferences;
+    NSMutableDictionary<NSArray *, NSNumber *> *_listReferences;
+    OCDSnapshotStringRef _baseDirectory;
+    OCDSnapshotStringRef _targetPlatformName;
+}
+
+- (instancetype)initWithBaseDirectory:(NSString *)baseDirectory targetPlatformName:(NSString *)targetPlatformName {
+    if (!(self = [super init]))
+        return nil;
+
+    _records = [[NSMutableData alloc] init];
+    _lists = [[NSMutableData alloc] init];
+    _strings = [[NSMutableData alloc] init];
+    _stringReferences = [[NSMutableDictionary alloc] init];
+    _listReferences = [[NSMutableDictionary alloc] init];
+    _baseDirectory = [self referenceForString:baseDirectory];
+    _targetPlatformName = [self referenceForString:targetPlatformName];
+
+    return self;
+}
+
+- (OCDSnapshotStringRef)referenceForString:(NSString *)string {
+    if (string == nil) {
+        return OCDSnapshotNullRef;
+    }
+
+    NSNumber *existingReference = _stringReferences[string];
+    if (existingReference != nil) {
+        return [existingReference unsignedIntValue];
+    }
+
+    OCDSnapshotStringRef reference = (OCDSnapshotStringRef)[_strings length];
+    const char *utf8 = [string UTF8String];
+    uint32_t length = (uint32_t)[string lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    static const uint8_t padding[sizeof(uint32_t)] = {0};
+
+    [_strings appendBytes:&length length:sizeof(length)];
+    [_strings appendBytes:utf8 length:length + 1];
+    [_strings appendBytes:padding length:(sizeof(uint32_t) - ([_strings length] % sizeof(uint32_t))) % sizeof(uint32_t)];
+
+    _stringReferences[string] = @(reference);
+
+    return reference;
+}
+
+- (OCDSnapshotListRef)referenceForStrings:(NSArray *)strings {
+    if ([strings count] == 0) {
+        return OCDSnapshotNullRef;
+    }
+
+    NSNumber *existingReference = _listReferences[strings];
+    if (existingReference != nil) {
+        return [existingReference unsignedIntValue];
+    }
+
+    OCDSnapshotListRef reference = (OCDSnapshotListRef)([_lists length] / sizeof(uint32_t));
+    uint32_t count = (uint32_t)[strings count];
+    [_lists appendBytes:&count length:sizeof(count)];
+
+    for (id string in strings) {
+        OCDSnapshotStringRef stringReference = (string != [NSNull null]) ? [self referenceForString:string] : OCDSnapshotNullRef;
+        [_lists appendBytes:&stringReference length:sizeof(stringReference)];
+    }
+
+    _listReferences[[strings copy]] = @(reference);
+
+    return reference;
+}
+
+- (void)addRecord:(const OCDSnapshotRecord *)record {
+    OCDSnapshotRecord fingerprintedRecord = *record;
+    fingerprintedRecord.fingerprint = [self fingerprintForRecord:record];
+
+    [_records appendBytes:&fingerprintedRecord length:sizeof(OCDSnapshotRecord)];
+    _recordCount++;
+}
+
+/**
+ * Returns the fingerprint of a record's key and of the values that OCDAPISnapshotComparator examines when deciding
+ * whether a matched declaration was modified.
+ *
+ * Values that are only reported once a modification has been found, such as the display name, declaration string,
+ * and deprecation message, are not included.
+ */
+- (uint64_t)fingerprintForRecord:(const OCDSnapshotRecord *)record {
+    // The comparator treats an unknown USR as unequal to every USR, even itself
+    BOOL hasUnknownSuperclass = (record->flags & OCDSnapshotRecordFlagHasSuperclass) && record->superclassUSR == OCDSnapshotNullRef;
+    BOOL hasUnknownGetter = (record->propertyAttributes & PLClangObjCPropertyAttributeGetter) && record->getterUSR == OCDSnapshotNullRef;
+    BOOL hasUnknownSetter = (record->propertyAttributes & PLClangObjCPropertyAttributeSetter) && record->setterUSR == OCDSnapshotNullRef;
+    if (hasUnknownSuperclass || hasUnknownGetter || hasUnknownSetter) {
+        return OCDSnapshotNoFingerprint;
+    }
+
+    // Likewise an unknown type spelling or protocol USR is unequal to every other
+    if ([self listContainsNullReference:record->types] || [self listContainsNullReference:record->protocols]) {
+        return OCDSnapshotNoFingerprint;
+    }
+
+    uint32_t values[] = { record->kind, record->flags, record->propertyAttributes, record->availabilityKind };
+    uint64_t hash = OCDHash64(values, sizeof(values), 0);
+
+    hash = [self hashString:record->key seed:hash];
+    hash = [self hashList:record->types seed:hash];
+    hash = [self hashList:record->protocols seed:hash];
+    hash = [self hashString:record->superclassUSR seed:hash];
+    hash = [self hashString:record->getterUSR seed:hash];
+    hash = [self hashString:record->setterUSR seed:hash];
+    hash = [self hashString:record->propertyKey seed:hash];
+
+    return hash != OCDSnapshotNoFingerprint ? hash : 1;
+}
+
+/**
+ * Returns the hash of a string in the string table, including its length prefix so that consecutive strings hash
+ * unambiguously, chained from the specified seed.
+ */
+- (uint64_t)hashString:(OCDSnapshotStringRef)reference seed:(uint64_t)seed {
+    if (reference == OCDSnapshotNullRef) {
+        return OCDHash64(&reference, sizeof(reference), seed);
+    }
+
+    const uint8_t *bytes = (const uint8_t *)[_strings bytes] + reference;
+    return OCDHash64(bytes, sizeof(uint32_t) + *(const uint32_t *)bytes, seed);
+}
+
+- (uint64_t)hashList:(OCDSnapshotListRef)reference seed:(uint64_t)seed {
+    if (reference == OCDSnapshotNullRef) {
+        return OCDHash64(&reference, sizeof(reference), seed);
+    }
+
+    const uint32_t *list = (const uint32_t *)[_lists bytes] + reference;
+    uint64_t hash = OCDHash64(list, sizeof(uint32_t), seed);
+    for (uint32_t i = 0; i < list[0]; i++) {
+        hash = [self hashString:list[1 + i] seed:hash];
+    }
+
+    return hash;
+}
+
+- (BOOL)listContainsNullReference:(OCDSnapshotListRef)reference {
+    if (reference == OCDSnapshotNullRef) {
+        return NO;
+    }
+
+    const uint32_t *list = (const uint32_t *)[_lists bytes] + reference;
+    for (uint32_t i = 0; i < list[0]; i++) {
+        if (list[1 + i] == OCDSnapshotNullRef) {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+- (OCDAPISnapshot *)snapshot {
+    OCDSnapshotHeader header = {
+        .magic = OCDSnapshotMagic,
+        .version = OCDAPISnapshotVersion,
+        .recordSize = sizeof(OCDSnapshotRecord),
+        .recordCount = (uint32_t)_recordCount,
+        .recordsOffset = sizeof(OCDSnapshotHeader),
+        .baseDirectory = _baseDirectory,
+        .targetPlatformName = _targetPlatformName
+    };
+
+    header.listsOffset = header.recordsOffset + (uint32_t)[_records length];
+    header.listsCount = (uint32_t)([_lists length] / sizeof(uint32_t));
+    header.stringsOffset = header.listsOffset + (uint32_t)[_lists length];
+    header.stringsLength = (uint32_t)[_strings length];
+
+    NSMutableData *data = [NSMutableData dataWithCapacity:header.stringsOffset + header.stringsLength];
+    [data appendBytes:&header length:sizeof(header)];
+    [data appendData:_records];
+    [data appendData:_lists];
+    [data appendData:_strings];
+
+    NSError *error;
+    OCDAPISnapshot *snapshot = [OCDAPISnapshot snapshotWithData:data error:&error];
+    NSAssert(snapshot != nil, @"Failed to load newly built snapshot: %@", error);
+
+    return snapshot;
+}
+
+@end
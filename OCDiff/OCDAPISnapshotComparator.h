@@ -0,0 +1,15 @@
+#import <Foundation/Foundation.h>
+#import "OCDAPISnapshot.h"
+#import "OCDifference.h"
+
+/**
+ * Compares two API snapshots.
+ *
+ * The differences reported are identical to those of OCDAPIComparator's reference comparison of the cursors of the
+ * sources the snapshots were created from, but no translation unit is required.
+ */
+@interface OCDAPISnapshotComparator : NSObject
+
++ (NSArray<OCDifference *> *)differencesBetweenOldSnapshot:(OCDAPISnapshot *)oldSnapshot newSnapshot:(OCDAPISnapshot *)newSnapshot;
+
+@end
@@ -0,0 +1,557 @@
+#import "OCDAPISnapshotComparator.h"
+#import <ObjectDoc/ObjectDoc.h>
+
+/** The record index used for keys that are not present in a snapshot. */
+static const uint32_t OCDNoRecord = UINT32_MAX;
+
+/** The minimum number of matched records compared by each concurrent task. */
+static const NSUInteger OCDMinimumComparisonChunkSize = 1024;
+
+/**
+ * The indexes of a record present in both snapshots.
+ */
+typedef struct {
+    uint32_t oldIndex;
+    uint32_t newIndex;
+} OCDRecordPair;
+
+/**
+ * The combined fingerprint of the records declared in a header.
+ */
+typedef struct {
+    uint64_t fingerprint;
+    uint32_t recordCount;
+
+    /** Whether any record in the header has no fingerprint, so that the header must always be compared. */
+    BOOL incomparable;
+} OCDHeaderFingerprint;
+
+@implementation OCDAPISnapshotComparator {
+    OCDAPISnapshot *_oldSnapshot;
+    OCDAPISnapshot *_newSnapshot;
+
+    /**
+     * The strings of both snapshots interned in a single table, so that old and new strings are compared as
+     * identifiers rather than by creating and hashing string objects.
+     */
+    OCDStringTable *_strings;
+    NSData *_oldIdentifierData;
+    NSData *_newIdentifierData;
+    const OCDStringID *_oldIdentifiers;
+    const OCDStringID *_newIdentifiers;
+
+    /**
+     * Identifiers of the keys for property declarations that have been converted to or from explicit accessor
+     * declarations.
+     *
+     * This is used to suppress reporting of the addition or removal of the property declaration, as this change is
+     * instead reported as a modification to the declaration of the accessor methods.
+     */
+    NSMutableIndexSet *_convertedProperties;
+}
+
+- (instancetype)initWithOldSnapshot:(OCDAPISnapshot *)oldSnapshot newSnapshot:(OCDAPISnapshot *)newSnapshot {
+    if (!(self = [super init]))
+        return nil;
+
+    _oldSnapshot = oldSnapshot;
+    _newSnapshot = newSnapshot;
+    _strings = [[OCDStringTable alloc] init];
+    _oldIdentifierData = [oldSnapshot identifiersForStringsInTable:_strings];
+    _newIdentifierData = [newSnapshot identifiersForStringsInTable:_strings];
+    _oldIdentifiers = [_oldIdentifierData bytes];
+    _newIdentifiers = [_newIdentifierData bytes];
+    _convertedProperties = [[NSMutableIndexSet alloc] init];
+
+    return self;
+}
+
++ (NSArray<OCDifference *> *)differencesBetweenOldSnapshot:(OCDAPISnapshot *)oldSnapshot newSnapshot:(OCDAPISnapshot *)newSnapshot {
+    OCDAPISnapshotComparator *comparator = [[self alloc] initWithOldSnapshot:oldSnapshot newSnapshot:newSnapshot];
+    return [comparator differences];
+}
+
+- (NSArray<OCDifference *> *)differences {
+    NSMutableArray *differences = [NSMutableArray array];
+    NSData *oldRecordIndexData = [self recordIndexesByKeyForSnapshot:_oldSnapshot identifiers:_oldIdentifiers];
+    NSData *newRecordIndexData = [self recordIndexesByKeyForSnapshot:_newSnapshot identifiers:_newIdentifiers];
+    const uint32_t *oldRecordIndexes = [oldRecordIndexData bytes];
+    const uint32_t *newRecordIndexes = [newRecordIndexData bytes];
+    NSMutableIndexSet *removals = [NSMutableIndexSet indexSet];
+
+    // A header whose records have the same combined fingerprint in both snapshots declares the same keys with the
+    // same fingerprints, so none of its records can be added, removed, or modified
+    NSData *unchangedHeaderData = [self unchangedHeaders];
+    const BOOL *unchangedHeaders = [unchangedHeaderData bytes];
+
+    NSMutableData *pairData = [NSMutableData dataWithLength:_oldSnapshot.recordCount * sizeof(OCDRecordPair)];
+    OCDRecordPair *pairs = [pairData mutableBytes];
+    NSUInteger pairCount = 0;
+
+    for (NSUInteger recordIndex = 0; recordIndex < _oldSnapshot.recordCount; recordIndex++) {
+        const OCDSnapshotRecord *record = &_oldSnapshot.records[recordIndex];
+        OCDStringID key = _oldIdentifiers[record->key / sizeof(uint32_t)];
+        if (oldRecordIndexes[key] != recordIndex)
+            continue;
+
+        uint32_t newIndex = newRecordIndexes[key];
+        const OCDSnapshotRecord *newRecord = (newIndex != OCDNoRecord) ? &_newSnapshot.records[newIndex] : NULL;
+        if ([self isRecord:record identifiers:_oldIdentifiers inUnchangedHeader:unchangedHeaders otherRecord:newRecord otherIdentifiers:_newIdentifiers])
+            continue;
+
+        if (newIndex != OCDNoRecord) {
+            pairs[pairCount++] = (OCDRecordPair){ .oldIndex = (uint32_t)recordIndex, .newIndex = newIndex };
+        } else {
+            [removals addIndex:recordIndex];
+        }
+    }
+
+    [self addDifferencesForRecordPairs:pairs count:pairCount toDifferences:differences];
+
+    [removals enumerateIndexesUsingBlock:^(NSUInteger recordIndex, BOOL *stop) {
+        const OCDSnapshotRecord *record = &_oldSnapshot.records[recordIndex];
+        OCDStringID key = _oldIdentifiers[record->key / sizeof(uint32_t)];
+        if ((record->flags & OCDSnapshotRecordFlagImplicit) || [_convertedProperties containsIndex:key])
+            return;
+
+        [differences addObject:[self differenceWithType:OCDifferenceTypeRemoval record:record snapshot:_oldSnapshot]];
+    }];
+
+    for (NSUInteger recordIndex = 0; recordIndex < _newSnapshot.recordCount; recordIndex++) {
+        const OCDSnapshotRecord *record = &_newSnapshot.records[recordIndex];
+        OCDStringID key = _newIdentifiers[record->key / sizeof(uint32_t)];
+        if (newRecordIndexes[key] != recordIndex || oldRecordIndexes[key] != OCDNoRecord)
+            continue;
+
+        if ([self isRecord:record identifiers:_newIdentifiers inUnchangedHeader:unchangedHeaders otherRecord:NULL otherIdentifiers:_oldIdentifiers])
+            continue;
+
+        if ((record->flags & OCDSnapshotRecordFlagImplicit) || [_convertedProperties containsIndex:key])
+            continue;
+
+        [differences addObject:[self differenceWithType:OCDifferenceTypeAddition record:record snapshot:_newSnapshot]];
+    }
+
+    [OCDifference sortDifferences:differences];
+
+    return differences;
+}
+
+/**
+ * Compares each pair of matched records and adds the differences found to the specified array.
+ *
+ * Snapshots are immutable, so pairs are compared concurrently in chunks. Each chunk collects its differences and
+ * converted properties separately, and these are merged in chunk order so that the result is the same as comparing
+ * every pair in turn.
+ */
+- (void)addDifferencesForRecordPairs:(const OCDRecordPair *)pairs count:(NSUInteger)pairCount toDifferences:(NSMutableArray *)differences {
+    if (pairCount == 0)
+        return;
+
+    NSUInteger processorCount = [[NSProcessInfo processInfo] activeProcessorCount];
+    NSUInteger chunkSize = MAX(OCDMinimumComparisonChunkSize, (pairCount + processorCount * 4 - 1) / (processorCount * 4));
+    NSUInteger chunkCount = (pairCount + chunkSize - 1) / chunkSize;
+
+    NSMutableArray<NSMutableArray *> *chunkDifferences = [NSMutableArray arrayWithCapacity:chunkCount];
+    NSMutableArray<NSMutableIndexSet *> *chunkConvertedProperties = [NSMutableArray arrayWithCapacity:chunkCount];
+    for (NSUInteger chunk = 0; chunk < chunkCount; chunk++) {
+        [chunkDifferences addObject:[NSMutableArray array]];
+        [chunkConvertedProperties addObject:[NSMutableIndexSet indexSet]];
+    }
+
+    void (^compareChunk)(size_t) = ^(size_t chunk) {
+        @autoreleasepool {
+            NSMutableArray *results = chunkDifferences[chunk];
+            NSMutableIndexSet *convertedProperties = chunkConvertedProperties[chunk];
+            NSUInteger end = MIN((chunk + 1) * chunkSize, pairCount);
+
+            for (NSUInteger pairIndex = chunk * chunkSize; pairIndex < end; pairIndex++) {
+                OCDifference *difference = [self differenceBetweenOldRecord:&_oldSnapshot.records[pairs[pairIndex].oldIndex]
+                                                                  newRecord:&_newSnapshot.records[pairs[pairIndex].newIndex]
+                                                        convertedProperties:convertedProperties];
+                if (difference != nil) {
+                    [results addObject:difference];
+                }
+            }
+        }
+    };
+
+    if (chunkCount == 1) {
+        compareChunk(0);
+    } else {
+        dispatch_apply(chunkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), compareChunk);
+    }
+
+    for (NSUInteger chunk = 0; chunk < chunkCount; chunk++) {
+        [differences addObjectsFromArray:chunkDifferences[chunk]];
+        [_convertedProperties addIndexes:chunkConvertedProperties[chunk]];
+    }
+}
+
+/**
+ * Returns the index of the record for each key in a snapshot, indexed by the key's identifier, or OCDNoRecord for
+ * keys that the snapshot does not contain.
+ *
+ * As with a dictionary, the last of several records with the same key is the one that is compared.
+ */
+- (NSData *)recordIndexesByKeyForSnapshot:(OCDAPISnapshot *)snapshot identifiers:(const OCDStringID *)identifiers {
+    NSMutableData *data = [NSMutableData dataWithLength:_strings.count * sizeof(uint32_t)];
+    uint32_t *indexes = [data mutableBytes];
+    memset(indexes, 0xFF, [data length]);
+
+    for (NSUInteger recordIndex = 0; recordIndex < snapshot.recordCount; recordIndex++) {
+        indexes[identifiers[snapshot.records[recordIndex].key / sizeof(uint32_t)]] = (uint32_t)recordIndex;
+    }
+
+    return data;
+}
+
+/**
+ * Returns a Boolean for each path identifier indicating whether the header at that path is unchanged between the
+ * snapshots.
+ */
+- (NSData *)unchangedHeaders {
+    NSUInteger count = _strings.count;
+    NSMutableData *oldHeaderData = [NSMutableData dataWithLength:count * sizeof(OCDHeaderFingerprint)];
+    NSMutableData *newHeaderData = [NSMutableData dataWithLength:count * sizeof(OCDHeaderFingerprint)];
+    OCDHeaderFingerprint *oldHeaders = [oldHeaderData mutableBytes];
+    OCDHeaderFingerprint *newHeaders = [newHeaderData mutableBytes];
+    [self addFingerprintsForSnapshot:_oldSnapshot identifiers:_oldIdentifiers toHeaders:oldHeaders];
+    [self addFingerprintsForSnapshot:_newSnapshot identifiers:_newIdentifiers toHeaders:newHeaders];
+
+    NSMutableData *data = [NSMutableData dataWithLength:count * sizeof(BOOL)];
+    BOOL *unchanged = [data mutableBytes];
+    for (NSUInteger identifier = 0; identifier < count; identifier++) {
+        unchanged[identifier] = (oldHeaders[identifier].recordCount > 0 &&
+                                 oldHeaders[identifier].recordCount == newHeaders[identifier].recordCount &&
+                                 oldHeaders[identifier].fingerprint == newHeaders[identifier].fingerprint &&
+                                 !oldHeaders[identifier].incomparable &&
+                                 !newHeaders[identifier].incomparable);
+    }
+
+    return data;
+}
+
+/**
+ * Returns a Boolean value indicating whether a record may be skipped because it is declared in a header that is
+ * unchanged between the snapshots.
+ *
+ * A header's fingerprint covers only the records declared in it, so a key may also be redeclared in another header
+ * whose record is the one compared in the other snapshot. The record is skipped only if the other snapshot's record
+ * for its key, if any, is declared in the same header.
+ */
+- (BOOL)isRecord:(const OCDSnapshotRecord *)record identifiers:(const OCDStringID *)identifiers inUnchangedHeader:(const BOOL *)unchangedHeaders otherRecord:(const OCDSnapshotRecord *)otherRecord otherIdentifiers:(const OCDStringID *)otherIdentifiers {
+    if (record->path == OCDSnapshotNullRef)
+        return NO;
+
+    OCDStringID path = identifiers[record->path / sizeof(uint32_t)];
+    if (!unchangedHeaders[path])
+        return NO;
+
+    if (otherRecord == NULL)
+        return YES;
+
+    return otherRecord->path != OCDSnapshotNullRef && otherIdentifiers[otherRecord->path / sizeof(uint32_t)] == path;
+}
+
+- (void)addFingerprintsForSnapshot:(OCDAPISnapshot *)snapshot identifiers:(const OCDStringID *)identifiers toHeaders:(OCDHeaderFingerprint *)headers {
+    for (NSUInteger recordIndex = 0; recordIndex < snapshot.recordCount; recordIndex++) {
+        const OCDSnapshotRecord *record = &snapshot.records[recordIndex];
+        if (record->path == OCDSnapshotNullRef)
+            continue;
+
+        // Record fingerprints include the key, so a sum is independent of record order
+        OCDHeaderFingerprint *header = &headers[identifiers[record->path / sizeof(uint32_t)]];
+        header->fingerprint += record->fingerprint;
+        header->recordCount++;
+        if (record->fingerprint == OCDSnapshotNoFingerprint) {
+            header->incomparable = YES;
+        }
+    }
+}
+
+- (OCDifference *)differenceWithType:(OCDifferenceType)type record:(const OCDSnapshotRecord *)record snapshot:(OCDAPISnapshot *)snapshot {
+    return [OCDifference differenceWithType:type
+                                  nameBlock:[self displayNameBlockForRecord:record snapshot:snapshot]
+                                       path:[snapshot stringForReference:record->path]
+                                 lineNumber:record->lineNumber
+                                        USR:[snapshot stringForReference:record->USR]
+                              modifications:nil];
+}
+
+/**
+ * Returns a block that formats the display name of a record when a difference's name is first read.
+ *
+ * The block retains the snapshot, which owns the record.
+ */
+- (NSString *(^)(void))displayNameBlockForRecord:(const OCDSnapshotRecord *)record snapshot:(OCDAPISnapshot *)snapshot {
+    return ^{
+        return [snapshot displayNameForRecord:record];
+    };
+}
+
+/**
+ * Returns the difference between two records with the same key, or nil if they are equivalent.
+ *
+ * The keys of properties found to have been converted to or from explicit accessors are added to the specified set
+ * rather than to the comparator's, so that records may be compared concurrently.
+ */
+- (OCDifference *)differenceBetweenOldRecord:(const OCDSnapshotRecord *)oldRecord newRecord:(const OCDSnapshotRecord *)newRecord convertedProperties:(NSMutableIndexSet *)convertedProperties {
+    NSMutableArray *modifications = [NSMutableArray array];
+    OCDSnapshotStringRef newUSR = newRecord->USR;
+    BOOL oldImplicit = (oldRecord->flags & OCDSnapshotRecordFlagImplicit) != 0;
+    BOOL newImplicit = (newRecord->flags & OCDSnapshotRecordFlagImplicit) != 0;
+
+    // Ignore changes to implicit declarations like synthesized property accessors
+    if (oldImplicit && newImplicit)
+        return nil;
+
+    // Records with equal fingerprints have equal values for everything examined below
+    if (oldRecord->fingerprint == newRecord->fingerprint && oldRecord->fingerprint != OCDSnapshotNoFingerprint)
+        return nil;
+
+    if (oldImplicit != newImplicit) {
+        // Report conversions between properties and explicit accessor methods as modifications to the declaration
+        // rather than additions or removals.
+        NSString *oldDeclaration;
+        NSString *newDeclaration;
+        OCDSnapshotStringRef propertyKey;
+        const OCDStringID *propertyKeyIdentifiers;
+
+        if (newImplicit) {
+            oldDeclaration = [_oldSnapshot stringForReference:oldRecord->declaration];
+            newDeclaration = [_newSnapshot stringForReference:newRecord->propertyDeclaration];
+            newUSR = newRecord->propertyUSR;
+            propertyKey = newRecord->propertyKey;
+            propertyKeyIdentifiers = _newIdentifiers;
+        } else {
+            oldDeclaration = [_oldSnapshot stringForReference:oldRecord->propertyDeclaration];
+            newDeclaration = [_newSnapshot stringForReference:newRecord->declaration];
+            propertyKey = oldRecord->propertyKey;
+            propertyKeyIdentifiers = _oldIdentifiers;
+        }
+
+        NSAssert(propertyKey != OCDSnapshotNullRef, @"Failed to locate property for conversion between property and explicit accessor");
+        if (propertyKey != OCDSnapshotNullRef) {
+            [convertedProperties addIndex:propertyKeyIdentifiers[propertyKey / sizeof(uint32_t)]];
+        }
+
+        OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                previousValue:oldDeclaration
+                                                                 currentValue:newDeclaration];
+        [modifications addObject:modification];
+    } else if ([self declarationChangedBetweenOldRecord:oldRecord newRecord:newRecord]) {
+        OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                previousValue:[_oldSnapshot stringForReference:oldRecord->declaration]
+                                                                 currentValue:[_newSnapshot stringForReference:newRecord->declaration]];
+        [modifications addObject:modification];
+    }
+
+    if (oldRecord->kind == PLClangCursorKindObjCInterfaceDeclaration) {
+        BOOL oldHasSuperclass = (oldRecord->flags & OCDSnapshotRecordFlagHasSuperclass) != 0;
+        BOOL newHasSuperclass = (newRecord->flags & OCDSnapshotRecordFlagHasSuperclass) != 0;
+        if (oldHasSuperclass != newHasSuperclass ||
+            (oldHasSuperclass && ![self oldReference:oldRecord->superclassUSR isEqualToNewReference:newRecord->superclassUSR])) {
+            OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeSuperclass
+                                                                    previousValue:[_oldSnapshot stringForReference:oldRecord->superclassSpelling]
+                                                                     currentValue:[_newSnapshot stringForReference:newRecord->superclassSpelling]];
+            [modifications addObject:modification];
+        }
+    }
+
+    if (oldRecord->kind == PLClangCursorKindObjCInterfaceDeclaration || oldRecord->kind == PLClangCursorKindObjCCategoryDeclaration || oldRecord->kind == PLClangCursorKindObjCProtocolDeclaration) {
+        NSUInteger oldCount;
+        NSUInteger newCount;
+        const OCDSnapshotStringRef *oldProtocols = [_oldSnapshot elementsOfList:oldRecord->protocols count:&oldCount];
+        const OCDSnapshotStringRef *newProtocols = [_newSnapshot elementsOfList:newRecord->protocols count:&newCount];
+        BOOL protocolsChanged = NO;
+        if (oldCount != newCount) {
+            protocolsChanged = YES;
+        } else {
+            // Protocol lists alternate USRs and spellings
+            for (NSUInteger protocolIndex = 0; protocolIndex < oldCount; protocolIndex += 2) {
+                if (![self oldReference:oldProtocols[protocolIndex] isEqualToNewReference:newProtocols[protocolIndex]]) {
+                    protocolsChanged = YES;
+                    break;
+                }
+            }
+        }
+
+        if (protocolsChanged) {
+            OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeProtocols
+                                                                    previousValue:[self stringForProtocols:oldProtocols count:oldCount snapshot:_oldSnapshot]
+                                                                     currentValue:[self stringForProtocols:newProtocols count:newCount snapshot:_newSnapshot]];
+            [modifications addObject:modification];
+        }
+    }
+
+    BOOL oldOptional = (oldRecord->flags & OCDSnapshotRecordFlagObjCOptional) != 0;
+    BOOL newOptional = (newRecord->flags & OCDSnapshotRecordFlagObjCOptional) != 0;
+    if (oldOptional != newOptional) {
+        OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeOptional
+                                                                previousValue:oldOptional ? @"Optional" : @"Required"
+                                                                 currentValue:newOptional ? @"Optional" : @"Required"];
+        [modifications addObject:modification];
+    }
+
+    PLClangAvailabilityKind oldAvailabilityKind = oldRecord->availabilityKind;
+    PLClangAvailabilityKind newAvailabilityKind = newRecord->availabilityKind;
+    if (oldAvailabilityKind != newAvailabilityKind) {
+        OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeAvailability
+                                                                previousValue:[self stringForAvailabilityKind:oldAvailabilityKind]
+                                                                 currentValue:[self stringForAvailabilityKind:newAvailabilityKind]];
+        [modifications addObject:modification];
+
+        NSString *deprecationMessage = [_newSnapshot stringForReference:newRecord->deprecationMessage];
+        NSString *replacement = [_newSnapshot stringForReference:newRecord->replacement];
+
+        if (newAvailabilityKind == PLClangAvailabilityKindDeprecated && [deprecationMessage length] > 0) {
+            modification = [OCDModification modificationWithType:OCDModificationTypeDeprecationMessage
+                                                   previousValue:nil
+                                                    currentValue:deprecationMessage];
+            [modifications addObject:modification];
+        } else if (newAvailabilityKind == PLClangAvailabilityKindDeprecated && [replacement length] > 0) {
+            modification = [OCDModification modificationWithType:OCDModificationTypeReplacement
+                                                   previousValue:nil
+                                                    currentValue:replacement];
+            [modifications addObject:modification];
+        }
+    }
+
+    if ([modifications count] > 0) {
+        return [OCDifference differenceWithType:OCDifferenceTypeModification
+                                      nameBlock:[self displayNameBlockForRecord:oldRecord snapshot:_oldSnapshot]
+                                           path:[_newSnapshot stringForReference:newRecord->path]
+                                     lineNumber:newRecord->lineNumber
+                                            USR:[_newSnapshot stringForReference:newUSR]
+                                  modifications:modifications];
+    }
+
+    return nil;
+}
+
+- (BOOL)declarationChangedBetweenOldRecord:(const OCDSnapshotRecord *)oldRecord newRecord:(const OCDSnapshotRecord *)newRecord {
+    switch (oldRecord->kind) {
+        case PLClangCursorKindObjCInstanceMethodDeclaration:
+        case PLClangCursorKindObjCClassMethodDeclaration:
+        {
+            // The result type and argument types are compared together
+            if ((oldRecord->flags & OCDSnapshotRecordFlagVariadic) != (newRecord->flags & OCDSnapshotRecordFlagVariadic)) {
+                return YES;
+            }
+
+            return ![self oldList:oldRecord->types isEqualToNewList:newRecord->types];
+        }
+
+        case PLClangCursorKindObjCPropertyDeclaration:
+        {
+            if (oldRecord->propertyAttributes != newRecord->propertyAttributes) {
+                return YES;
+            }
+
+            if (![self oldList:oldRecord->types isEqualToNewList:newRecord->types]) {
+                return YES;
+            }
+
+            if (oldRecord->propertyAttributes & PLClangObjCPropertyAttributeGetter && ![self oldReference:oldRecord->getterUSR isEqualToNewReference:newRecord->getterUSR]) {
+                return YES;
+            }
+
+            if (oldRecord->propertyAttributes & PLClangObjCPropertyAttributeSetter && ![self oldReference:oldRecord->setterUSR isEqualToNewReference:newRecord->setterUSR]) {
+                return YES;
+            }
+
+            break;
+        }
+
+        case PLClangCursorKindFunctionDeclaration:
+        case PLClangCursorKindVariableDeclaration:
+        {
+            return ![self oldList:oldRecord->types isEqualToNewList:newRecord->types];
+        }
+
+        case PLClangCursorKindTypedefDeclaration:
+        {
+            // Report changes to block and function pointer typedefs. As with OCDAPIComparator, a block typedef is
+            // compared regardless of the kind of the new typedef.
+
+            if (oldRecord->flags & OCDSnapshotRecordFlagBlockPointerTypedef) {
+                return ![self oldList:oldRecord->types isEqualToNewList:newRecord->types];
+            }
+
+            if ((oldRecord->flags & OCDSnapshotRecordFlagFunctionPointerTypedef) && (newRecord->flags & OCDSnapshotRecordFlagFunctionPointerTypedef)) {
+                return ![self oldList:oldRecord->types isEqualToNewList:newRecord->types];
+            }
+
+            break;
+        }
+
+        default:
+        {
+            break;
+        }
+    }
+
+    return NO;
+}
+
+/**
+ * Returns a Boolean value indicating whether a string in the old snapshot is equal to a string in the new snapshot.
+ *
+ * References are only comparable within a single snapshot, so the strings' identifiers in the shared table are
+ * compared. As with -isEqual:, a nil string is not equal to any string.
+ */
+- (BOOL)oldReference:(OCDSnapshotStringRef)oldReference isEqualToNewReference:(OCDSnapshotStringRef)newReference {
+    if (oldReference == OCDSnapshotNullRef || newReference == OCDSnapshotNullRef) {
+        return NO;
+    }
+
+    return _oldIdentifiers[oldReference / sizeof(uint32_t)] == _newIdentifiers[newReference / sizeof(uint32_t)];
+}
+
+- (BOOL)oldList:(OCDSnapshotListRef)oldList isEqualToNewList:(OCDSnapshotListRef)newList {
+    NSUInteger oldCount;
+    NSUInteger newCount;
+    const OCDSnapshotStringRef *oldElements = [_oldSnapshot elementsOfList:oldList count:&oldCount];
+    const OCDSnapshotStringRef *newElements = [_newSnapshot elementsOfList:newList count:&newCount];
+    if (oldCount != newCount) {
+        return NO;
+    }
+
+    for (NSUInteger i = 0; i < oldCount; i++) {
+        if (![self oldReference:oldElements[i] isEqualToNewReference:newElements[i]]) {
+            return NO;
+        }
+    }
+
+    return YES;
+}
+
+- (NSString *)stringForProtocols:(const OCDSnapshotStringRef *)protocols count:(NSUInteger)count snapshot:(OCDAPISnapshot *)snapshot {
+    NSMutableArray *protocolNames = [NSMutableArray array];
+    for (NSUInteger protocolIndex = 1; protocolIndex < count; protocolIndex += 2) {
+        [protocolNames addObject:[snapshot stringForReference:protocols[protocolIndex]]];
+    }
+
+    return [protocolNames count] > 0 ? [protocolNames componentsJoinedByString:@", "] : nil;
+}
+
+- (NSString *)stringForAvailabilityKind:(PLClangAvailabilityKind)kind {
+    switch (kind) {
+        case PLClangAvailabilityKindAvailable:
+            return @"Available";
+
+        case PLClangAvailabilityKindDeprecated:
+            return @"Deprecated";
+
+        case PLClangAvailabilityKindUnavailable:
+            return @"Unavailable";
+
+        case PLClangAvailabilityKindInaccessible:
+            return @"Inaccessible";
+    }
+
+    abort();
+}
+
+@end
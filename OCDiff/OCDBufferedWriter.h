@@ -0,0 +1,60 @@
+#import <Foundation/Foundation.h>
+
+/**
+ * Writes UTF-8 text to a file descriptor through a fixed-size buffer.
+ *
+ * Strings are encoded directly into the buffer, which is written out whenever it fills, so memory use does not grow
+ * with the amount of text written. Write errors are recorded and reported by -close:.
+ */
+@interface OCDBufferedWriter : NSObject
+
+/**
+ * Returns a writer for a new file at the specified path, replacing any existing file, or nil if the file could not
+ * be created.
+ */
++ (instancetype)writerWithPath:(NSString *)path error:(NSError **)error;
+
+/**
+ * Returns a writer for standard output.
+ */
++ (instancetype)standardOutputWriter;
+
+/**
+ * Writes a string. A nil string is written as "(null)", as it is by a %@ format specifier.
+ */
+- (void)writeString:(NSString *)string;
+
+/**
+ * Writes a NUL-terminated UTF-8 string, such as a literal.
+ */
+- (void)writeUTF8String:(const char *)string;
+
+/**
+ * Writes a string with the XML special characters &, <, >, ", and ' replaced by entity references.
+ *
+ * The output is identical to that of CFXMLCreateStringByEscapingEntities with no additional entities. A nil string
+ * is written as "(null)".
+ */
+- (void)writeEscapedString:(NSString *)string;
+
+/**
+ * Writes any buffered text to the file descriptor.
+ */
+- (BOOL)flush:(NSError **)error;
+
+/**
+ * Flushes the writer and closes its file, unless it is writing to standard output.
+ *
+ * @return NO if any write failed.
+ */
+- (BOOL)close:(NSError **)error;
+
+@end
+
+/**
+ * Returns the offset of the first of the bytes &, <, >, ", or ' in the specified UTF-8 string, or length if it
+ * contains none.
+ *
+ * Eight bytes are examined at a time, so text without special characters is scanned at close to memory speed.
+ */
+size_t OCDFindXMLSpecialCharacter(const uint8_t *bytes, size_t length);
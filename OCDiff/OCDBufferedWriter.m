@@ -0,0 +1,251 @@
+#import "OCDBufferedWriter.h"
+
+static const size_t OCDBufferedWriterCapacity = 64 * 1024;
+
+static const uint64_t OCDOneBytes = 0x0101010101010101ULL;
+static const uint64_t OCDHighBits = 0x8080808080808080ULL;
+
+/**
+ * Returns a word with the high bit set in the lowest byte of the specified word that equals the byte replicated
+ * in pattern, if any. Bits above the lowest match may also be set, so only the lowest set bit is meaningful.
+ */
+static inline uint64_t OCDMatchBytes(uint64_t word, uint64_t pattern) {
+    uint64_t x = word ^ pattern;
+    return (x - OCDOneBytes) & ~x & OCDHighBits;
+}
+
+static inline BOOL OCDIsXMLSpecialCharacter(uint8_t byte) {
+    return byte == '&' || byte == '<' || byte == '>' || byte == '"' || byte == '\'';
+}
+
+size_t OCDFindXMLSpecialCharacter(const uint8_t *bytes, size_t length) {
+    size_t offset = 0;
+
+    // Words are loaded in little-endian order, so the lowest set bit of a match is the first matching byte
+    for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + offset, sizeof(word));
+
+        uint64_t matches = (OCDMatchBytes(word, OCDOneBytes * '&') |
+                            OCDMatchBytes(word, OCDOneBytes * '<') |
+                            OCDMatchBytes(word, OCDOneBytes * '>') |
+                            OCDMatchBytes(word, OCDOneBytes * '"') |
+                            OCDMatchBytes(word, OCDOneBytes * '\''));
+        if (matches != 0) {
+            return offset + (__builtin_ctzll(matches) >> 3);
+        }
+    }
+
+    for (; offset < length; offset++) {
+        if (OCDIsXMLSpecialCharacter(bytes[offset])) {
+            return offset;
+        }
+    }
+
+    return length;
+}
+
+@implementation OCDBufferedWriter {
+    int _fileDescriptor;
+    BOOL _closesFileDescriptor;
+    BOOL _closed;
+    uint8_t *_buffer;
+    size_t _length;
+
+    /** Holds the UTF-8 encoding of strings that do not expose one directly. */
+    NSMutableData *_scratch;
+
+    /** The errno of the first failed write, or zero. */
+    int _writeError;
+}
+
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor closesFileDescriptor:(BOOL)closesFileDescriptor {
+    if (!(self = [super init]))
+        return nil;
+
+    _fileDescriptor = fileDescriptor;
+    _closesFileDescriptor = closesFileDescriptor;
+    _buffer = malloc(OCDBufferedWriterCapacity);
+    _scratch = [[NSMutableData alloc] init];
+
+    return self;
+}
+
+- (void)dealloc {
+    if (!_closed) {
+        [self close:NULL];
+    }
+
+    free(_buffer);
+}
+
++ (instancetype)writerWithPath:(NSString *)path error:(NSError **)error {
+    int fileDescriptor = open([path fileSystemRepresentation], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+        }
+        return nil;
+    }
+
+    return [[self alloc] initWithFileDescriptor:fileDescriptor closesFileDescriptor:YES];
+}
+
++ (instancetype)standardOutputWriter {
+    return [[self alloc] initWithFileDescriptor:STDOUT_FILENO closesFileDescriptor:NO];
+}
+
+- (void)writeBytes:(const void *)bytes length:(size_t)length {
+    if (length > OCDBufferedWriterCapacity - _length) {
+        [self flushBuffer];
+
+        if (length >= OCDBufferedWriterCapacity) {
+            [self writeBytesToFile:bytes length:length];
+            return;
+        }
+    }
+
+    memcpy(_buffer + _length, bytes, length);
+    _length += length;
+}
+
+- (void)writeString:(NSString *)string {
+    size_t length;
+    const uint8_t *bytes = [self UTF8BytesForString:string length:&length];
+    [self writeBytes:bytes length:length];
+}
+
+- (void)writeUTF8String:(const char *)string {
+    [self writeBytes:string length:strlen(string)];
+}
+
+- (void)writeEscapedString:(NSString *)string {
+    size_t length;
+    const uint8_t *bytes = [self UTF8BytesForString:string length:&length];
+    size_t start = 0;
+
+    while (start < length) {
+        size_t offset = start + OCDFindXMLSpecialCharacter(bytes + start, length - start);
+        [self writeBytes:bytes + start length:offset - start];
+
+        if (offset == length)
+            break;
+
+        switch (bytes[offset]) {
+            case '&':
+                [self writeUTF8String:"&amp;"];
+                break;
+
+            case '<':
+                [self writeUTF8String:"&lt;"];
+                break;
+
+            case '>':
+                [self writeUTF8String:"&gt;"];
+                break;
+
+            case '"':
+                [self writeUTF8String:"&quot;"];
+                break;
+
+            case '\'':
+                [self writeUTF8String:"&apos;"];
+                break;
+        }
+
+        start = offset + 1;
+    }
+}
+
+/**
+ * Returns the UTF-8 encoding of a string, either directly from the string's storage or encoded into the scratch
+ * buffer. The bytes are valid until the next call.
+ */
+- (const uint8_t *)UTF8BytesForString:(NSString *)string length:(size_t *)length {
+    CFStringRef cfString = (__bridge CFStringRef)string;
+    if (cfString == NULL) {
+        *length = strlen("(null)");
+        return (const uint8_t *)"(null)";
+    }
+
+    // Storage is only exposed as UTF-8 for ASCII strings, which are one byte per character. The length is taken from
+    // the string rather than by scanning for a terminator, so that any embedded NUL characters are also written.
+    CFIndex characterCount = CFStringGetLength(cfString);
+    const char *cString = CFStringGetCStringPtr(cfString, kCFStringEncodingUTF8);
+    if (cString != NULL) {
+        *length = characterCount;
+        return (const uint8_t *)cString;
+    }
+
+    CFIndex maximumLength = CFStringGetMaximumSizeForEncoding(characterCount, kCFStringEncodingUTF8);
+    if ((CFIndex)[_scratch length] < maximumLength) {
+        [_scratch setLength:maximumLength];
+    }
+
+    CFIndex usedLength = 0;
+    CFStringGetBytes(cfString, CFRangeMake(0, characterCount), kCFStringEncodingUTF8, '?', false, [_scratch mutableBytes], maximumLength, &usedLength);
+
+    *length = usedLength;
+    return [_scratch mutableBytes];
+}
+
+- (void)flushBuffer {
+    [self writeBytesToFile:_buffer length:_length];
+    _length = 0;
+}
+
+- (void)writeBytesToFile:(const uint8_t *)bytes length:(size_t)length {
+    if (_writeError != 0)
+        return;
+
+    if (_fileDescriptor == STDOUT_FILENO) {
+        // Keep any output written through stdio in order with this writer's output
+        fflush(stdout);
+    }
+
+    while (length > 0) {
+        ssize_t written = write(_fileDescriptor, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            _writeError = errno;
+            return;
+        }
+
+        bytes += written;
+        length -= written;
+    }
+}
+
+- (BOOL)flush:(NSError **)error {
+    [self flushBuffer];
+
+    if (_writeError != 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:_writeError userInfo:nil];
+        }
+        return NO;
+    }
+
+    return YES;
+}
+
+- (BOOL)close:(NSError **)error {
+    if (_closed)
+        return YES;
+
+    BOOL success = [self flush:error];
+    _closed = YES;
+
+    if (_closesFileDescriptor && close(_fileDescriptor) != 0 && success) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        }
+        success = NO;
+    }
+
+    return success;
+}
+
+@end
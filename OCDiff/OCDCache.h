@@ -0,0 +1,64 @@
+#import <Foundation/Foundation.h>
+
+/**
+ * A persistent, content-addressed file cache that may be shared by concurrent processes.
+ *
+ * Entries are identified by a key derived from everything that affects their contents, so an entry is never
+ * modified once stored. Entries are published by atomically renaming a completed file into place, so a reader
+ * either sees no entry or a complete one, and concurrent writers of the same entry simply replace one another's
+ * identical results.
+ */
+@interface OCDCache : NSObject
+
+/**
+ * Returns the default cache directory, ~/Library/Caches/objc-diff.
+ */
++ (NSString *)defaultDirectory;
+
+/**
+ * Returns a cache rooted at the specified directory, creating the directory if necessary.
+ *
+ * Returns nil if the directory could not be created.
+ */
++ (instancetype)cacheWithDirectory:(NSString *)directory error:(NSError **)error;
+
+/**
+ * Returns a key identifying an entry with the specified components.
+ *
+ * Each component must be either a string or data. The key is a hexadecimal SHA-256 digest of the components.
+ * Components are order-sensitive and delimited, so that distinct lists of components produce distinct keys.
+ */
++ (NSString *)keyForComponents:(NSArray *)components;
+
+/**
+ * Returns the path of the entry with the specified key and extension if it exists, otherwise nil.
+ */
+- (NSString *)pathForKey:(NSString *)key extension:(NSString *)extension;
+
+/**
+ * Copies the file at the specified path into the cache as the entry with the specified key and extension,
+ * replacing any existing entry.
+ *
+ * Returns the path of the stored entry, or nil if it could not be stored.
+ */
+- (NSString *)storeFileAtPath:(NSString *)path forKey:(NSString *)key extension:(NSString *)extension error:(NSError **)error;
+
+/**
+ * Stores the specified data in the cache as the entry with the specified key and extension, replacing any existing
+ * entry.
+ *
+ * Returns the path of the stored entry, or nil if it could not be stored.
+ */
+- (NSString *)storeData:(NSData *)data forKey:(NSString *)key extension:(NSString *)extension error:(NSError **)error;
+
+/**
+ * Removes the entry with the specified key and extension, if any.
+ *
+ * Used to discard an entry that turned out to be unusable, such as a precompiled header whose inputs have changed
+ * since it was built.
+ */
+- (void)removeEntryForKey:(NSString *)key extension:(NSString *)extension;
+
+@property (nonatomic, readonly, copy) NSString *directory;
+
+@end
@@ -0,0 +1,111 @@
+#import "OCDCache.h"
+#import <CommonCrypto/CommonDigest.h>
+
+@implementation OCDCache
+
+- (instancetype)initWithDirectory:(NSString *)directory {
+    if (!(self = [super init]))
+        return nil;
+
+    _directory = [directory copy];
+
+    return self;
+}
+
++ (NSString *)defaultDirectory {
+    NSString *cachesPath = [NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES) firstObject] ?: NSTemporaryDirectory();
+    return [cachesPath stringByAppendingPathComponent:@"objc-diff"];
+}
+
++ (instancetype)cacheWithDirectory:(NSString *)directory error:(NSError **)error {
+    if ([[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:error] == NO) {
+        return nil;
+    }
+
+    return [[self alloc] initWithDirectory:directory];
+}
+
++ (NSString *)keyForComponents:(NSArray *)components {
+    CC_SHA256_CTX context;
+    CC_SHA256_Init(&context);
+
+    for (id component in components) {
+        // Prefix each component with its length so that no two lists of components hash the same input
+        NSData *data = [component isKindOfClass:[NSData class]] ? component : [component dataUsingEncoding:NSUTF8StringEncoding];
+        uint64_t length = [data length];
+        CC_SHA256_Update(&context, &length, sizeof(length));
+        CC_SHA256_Update(&context, [data bytes], (CC_LONG)[data length]);
+    }
+
+    unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+    CC_SHA256_Final(digest, &context);
+
+    NSMutableString *key = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+    for (size_t i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+        [key appendFormat:@"%02x", digest[i]];
+    }
+
+    return key;
+}
+
+- (NSString *)entryPathForKey:(NSString *)key extension:(NSString *)extension {
+    return [_directory stringByAppendingPathComponent:[key stringByAppendingPathExtension:extension]];
+}
+
+- (NSString *)pathForKey:(NSString *)key extension:(NSString *)extension {
+    NSString *path = [self entryPathForKey:key extension:extension];
+    return [[NSFileManager defaultManager] fileExistsAtPath:path] ? path : nil;
+}
+
+/**
+ * Returns a unique path within the cache directory for a file that is not yet an entry.
+ *
+ * The temporary file must reside on the same volume as the entry for rename(2) to publish it atomically.
+ */
+- (NSString *)temporaryPathForKey:(NSString *)key {
+    return [_directory stringByAppendingPathComponent:[NSString stringWithFormat:@".%@-%@.tmp", key, [[NSUUID UUID] UUIDString]]];
+}
+
+/**
+ * Atomically moves a completed temporary file into place as an entry, replacing any existing entry.
+ */
+- (NSString *)publishTemporaryPath:(NSString *)temporaryPath forKey:(NSString *)key extension:(NSString *)extension error:(NSError **)error {
+    NSString *path = [self entryPathForKey:key extension:extension];
+    if (rename([temporaryPath fileSystemRepresentation], [path fileSystemRepresentation]) != 0) {
+        if (error != NULL) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{NSFilePathErrorKey: path}];
+        }
+
+        [[NSFileManager defaultManager] removeItemAtPath:temporaryPath error:NULL];
+        return nil;
+    }
+
+    return path;
+}
+
+- (NSString *)storeFileAtPath:(NSString *)sourcePath forKey:(NSString *)key extension:(NSString *)extension error:(NSError **)error {
+    NSString *temporaryPath = [self temporaryPathForKey:key];
+    if ([[NSFileManager defaultManager] copyItemAtPath:sourcePath toPath:temporaryPath error:error] == NO) {
+        [[NSFileManager defaultManager] removeItemAtPath:temporaryPath error:NULL];
+        return nil;
+    }
+
+    return [self publishTemporaryPath:temporaryPath forKey:key extension:extension error:error];
+}
+
+- (NSString *)storeData:(NSData *)data forKey:(NSString *)key extension:(NSString *)extension error:(NSError **)error {
+    NSString *temporaryPath = [self temporaryPathForKey:key];
+    if ([data writeToFile:temporaryPath options:0 error:error] == NO) {
+        [[NSFileManager defaultManager] removeItemAtPath:temporaryPath error:NULL];
+        return nil;
+    }
+
+    return [self publishTemporaryPath:temporaryPath forKey:key extension:extension error:error];
+}
+
+- (void)removeEntryForKey:(NSString *)key extension:(NSString *)extension {
+    // unlink(2) only removes the directory entry, so processes already reading the entry are unaffected
+    unlink([[self entryPathForKey:key extension:extension] fileSystemRepresentation]);
+}
+
+@end
@@ -0,0 +1,111 @@
+#import <Foundation/Foundation.h>
+#import <ObjectDoc/ObjectDoc.h>
+
+/**
+ * The cursor properties memoized by OCDCursor.
+ */
+typedef NS_ENUM(NSUInteger, OCDCursorProperty) {
+    OCDCursorPropertyKind,
+    OCDCursorPropertySpelling,
+    OCDCursorPropertyUSR,
+    OCDCursorPropertyLocation,
+    OCDCursorPropertyPath,
+    OCDCursorPropertyAvailability,
+    OCDCursorPropertyCanonicalCursor,
+    OCDCursorPropertySemanticParent,
+    OCDCursorPropertyIsDeclaration,
+    OCDCursorPropertyIsImplicit,
+
+    OCDCursorPropertyCount
+};
+
+/**
+ * A cursor that reads each of the properties the API comparator uses most frequently from libclang at most once.
+ *
+ * Every read of a PLClangCursor property is a libclang call, and most return a new object. Extraction reads the
+ * kind, spelling, USR, location, and availability of each cursor several times as it is filtered, keyed, and
+ * recorded, so the comparator wraps each cursor it visits in an OCDCursor and reads through it instead.
+ *
+ * Properties that are not memoized are read from the underlying cursor. Like the translation unit it belongs to, an
+ * OCDCursor must only be used from one thread at a time.
+ */
+@interface OCDCursor : NSObject
+
++ (instancetype)cursorWithCursor:(PLClangCursor *)cursor;
+
+/**
+ * The underlying cursor.
+ */
+@property (nonatomic, readonly) PLClangCursor *cursor;
+
+@property (nonatomic, readonly) PLClangCursorKind kind;
+@property (nonatomic, readonly) NSString *spelling;
+@property (nonatomic, readonly) NSString *USR;
+@property (nonatomic, readonly) PLClangSourceLocation *location;
+
+/**
+ * The path of the cursor's location.
+ */
+@property (nonatomic, readonly) NSString *path;
+
+@property (nonatomic, readonly) PLClangAvailability *availability;
+@property (nonatomic, readonly) PLClangCursor *canonicalCursor;
+@property (nonatomic, readonly) PLClangCursor *semanticParent;
+@property (nonatomic, readonly) BOOL isDeclaration;
+@property (nonatomic, readonly) BOOL isImplicit;
+
+/**
+ * For an Objective-C method or property, the class, category, or protocol that declares it.
+ *
+ * This and the following relationships are recorded by OCDAPIComparator as it extracts an API, and are nil for
+ * cursors that are not part of an extracted API.
+ */
+@property (nonatomic, strong) OCDCursor *container;
+
+/**
+ * For an implicit Objective-C accessor method, the property that declared it.
+ */
+@property (nonatomic, strong) OCDCursor *propertyCursor;
+
+/**
+ * For an Objective-C class, the referenced superclass.
+ */
+@property (nonatomic, strong) PLClangCursor *superclassCursor;
+
+/**
+ * For an Objective-C category, the referenced class it extends.
+ */
+@property (nonatomic, strong) PLClangCursor *classCursor;
+
+/**
+ * For an Objective-C class, the categories within the same API that extend it.
+ */
+@property (nonatomic, copy) NSArray<OCDCursor *> *categories;
+
+/**
+ * For an Objective-C class, category, or protocol, the referenced protocols it conforms to sorted by name. The
+ * protocols of a class include those added by its categories.
+ */
+@property (nonatomic, copy) NSOrderedSet<PLClangCursor *> *protocolCursors;
+
+/**
+ * Enables or disables counting of property reads across all instances. Counting is disabled by default.
+ */
++ (void)setCollectsStatistics:(BOOL)collectsStatistics;
+
+/**
+ * Returns the number of reads of the specified property that were answered without calling libclang.
+ */
++ (uint64_t)hitCountForProperty:(OCDCursorProperty)property;
+
+/**
+ * Returns the number of reads of the specified property that called libclang.
+ */
++ (uint64_t)missCountForProperty:(OCDCursorProperty)property;
+
+/**
+ * Returns the name of the specified property for display.
+ */
++ (NSString *)nameForProperty:(OCDCursorProperty)property;
+
+@end
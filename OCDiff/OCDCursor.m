@@ -0,0 +1,186 @@
+#import "OCDCursor.h"
+#import <stdatomic.h>
+
+static BOOL OCDCursorCollectsStatistics = NO;
+static _Atomic uint64_t OCDCursorHitCounts[OCDCursorPropertyCount];
+static _Atomic uint64_t OCDCursorMissCounts[OCDCursorPropertyCount];
+
+/**
+ * Marks a property as loaded and returns whether it was already loaded, counting the read if statistics are enabled.
+ */
+static inline BOOL OCDCursorBeginRead(uint32_t *loadedProperties, OCDCursorProperty property) {
+    BOOL loaded = (*loadedProperties & (1U << property)) != 0;
+    *loadedProperties |= (1U << property);
+
+    if (OCDCursorCollectsStatistics) {
+        atomic_fetch_add_explicit(loaded ? &OCDCursorHitCounts[property] : &OCDCursorMissCounts[property], 1, memory_order_relaxed);
+    }
+
+    return loaded;
+}
+
+@implementation OCDCursor {
+    uint32_t _loadedProperties;
+    PLClangCursorKind _kind;
+    NSString *_spelling;
+    NSString *_USR;
+    PLClangSourceLocation *_location;
+    NSString *_path;
+    PLClangAvailability *_availability;
+    PLClangCursor *_canonicalCursor;
+    PLClangCursor *_semanticParent;
+    BOOL _isDeclaration;
+    BOOL _isImplicit;
+}
+
++ (instancetype)cursorWithCursor:(PLClangCursor *)cursor {
+    return [[self alloc] initWithCursor:cursor];
+}
+
+- (instancetype)initWithCursor:(PLClangCursor *)cursor {
+    if (!(self = [super init]))
+        return nil;
+
+    _cursor = cursor;
+
+    return self;
+}
+
+- (PLClangCursorKind)kind {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyKind)) {
+        _kind = _cursor.kind;
+    }
+
+    return _kind;
+}
+
+- (NSString *)spelling {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertySpelling)) {
+        _spelling = _cursor.spelling;
+    }
+
+    return _spelling;
+}
+
+- (NSString *)USR {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyUSR)) {
+        _USR = _cursor.USR;
+    }
+
+    return _USR;
+}
+
+- (PLClangSourceLocation *)location {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyLocation)) {
+        _location = _cursor.location;
+    }
+
+    return _location;
+}
+
+- (NSString *)path {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyPath)) {
+        _path = self.location.path;
+    }
+
+    return _path;
+}
+
+- (PLClangAvailability *)availability {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyAvailability)) {
+        _availability = _cursor.availability;
+    }
+
+    return _availability;
+}
+
+- (PLClangCursor *)canonicalCursor {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyCanonicalCursor)) {
+        _canonicalCursor = _cursor.canonicalCursor;
+    }
+
+    return _canonicalCursor;
+}
+
+- (PLClangCursor *)semanticParent {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertySemanticParent)) {
+        _semanticParent = _cursor.semanticParent;
+    }
+
+    return _semanticParent;
+}
+
+- (BOOL)isDeclaration {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyIsDeclaration)) {
+        _isDeclaration = _cursor.isDeclaration;
+    }
+
+    return _isDeclaration;
+}
+
+- (BOOL)isImplicit {
+    if (!OCDCursorBeginRead(&_loadedProperties, OCDCursorPropertyIsImplicit)) {
+        _isImplicit = _cursor.isImplicit;
+    }
+
+    return _isImplicit;
+}
+
+- (NSString *)description {
+    return [_cursor description];
+}
+
++ (void)setCollectsStatistics:(BOOL)collectsStatistics {
+    OCDCursorCollectsStatistics = collectsStatistics;
+}
+
++ (uint64_t)hitCountForProperty:(OCDCursorProperty)property {
+    NSParameterAssert(property < OCDCursorPropertyCount);
+    return atomic_load_explicit(&OCDCursorHitCounts[property], memory_order_relaxed);
+}
+
++ (uint64_t)missCountForProperty:(OCDCursorProperty)property {
+    NSParameterAssert(property < OCDCursorPropertyCount);
+    return atomic_load_explicit(&OCDCursorMissCounts[property], memory_order_relaxed);
+}
+
++ (NSString *)nameForProperty:(OCDCursorProperty)property {
+    switch (property) {
+        case OCDCursorPropertyKind:
+            return @"kind";
+
+        case OCDCursorPropertySpelling:
+            return @"spelling";
+
+        case OCDCursorPropertyUSR:
+            return @"USR";
+
+        case OCDCursorPropertyLocation:
+            return @"location";
+
+        case OCDCursorPropertyPath:
+            return @"path";
+
+        case OCDCursorPropertyAvailability:
+            return @"availability";
+
+        case OCDCursorPropertyCanonicalCursor:
+            return @"canonicalCursor";
+
+        case OCDCursorPropertySemanticParent:
+            return @"semanticParent";
+
+        case OCDCursorPropertyIsDeclaration:
+            return @"isDeclaration";
+
+        case OCDCursorPropertyIsImplicit:
+            return @"isImplicit";
+
+        case OCDCursorPropertyCount:
+            break;
+    }
+
+    abort();
+}
+
+@end
@@ -1,4 +1,5 @@
 #import "OCDHTMLReportGenerator.h"
+#import "OCDBufferedWriter.h"
 #import <mach-o/dyld.h>
 #import <mach-o/getsect.h>
 #import <mach-o/ldsyms.h>
@@ -6,6 +7,17 @@
 @implementation OCDHTMLReportGenerator {
     NSString *_outputDirectory;
     OCDLinkMap *_linkMap;
+    NSString *_title;
+    BOOL _multipleModules;
+    BOOL _hasDifferences;
+    NSMutableString *_indexHTML;
+
+    /**
+     * Module pages are rendered and written concurrently while the index is assembled in report order. The semaphore
+     * bounds the number of pages in progress, and so the number of modules retained at once.
+     */
+    dispatch_group_t _pageGroup;
+    dispatch_semaphore_t _pageSemaphore;
 }
 
 - (instancetype)initWithOutputDirectory:(NSString *)directory linkMap:(OCDLinkMap *)linkMap {
@@ -19,6 +31,16 @@
 }
 
 - (void)generateReportForDifferences:(OCDAPIDifferences *)differences title:(NSString *)title {
+    [self beginReportWithTitle:title multipleModules:(differences.modules.count != 1)];
+
+    for (OCDModule *module in differences.modules) {
+        [self reportModule:module];
+    }
+
+    [self endReport];
+}
+
+- (void)beginReportWithTitle:(NSString *)title multipleModules:(BOOL)multipleModules {
     NSError *error = nil;
     if (![[NSFileManager defaultManager] createDirectoryAtPath:_outputDirectory withIntermediateDirectories:YES attributes:nil error:&error]) {
         fprintf(stderr, "Error creating directory at path %s: %s\n", [_outputDirectory UTF8String], [[error description] UTF8String]);
@@ -35,11 +57,15 @@
         exit(1);
     }
 
-    if (differences.modules.count == 1) {
-        outputFile = [_outputDirectory stringByAppendingPathComponent:@"apidiff.html"];
-        [self generateFileForDifferences:differences.modules.firstObject.differences title:title path:outputFile];
-    } else {
-        BOOL hasDifferences = NO;
+    _title = [title copy];
+    _multipleModules = multipleModules;
+    _hasDifferences = NO;
+    _indexHTML = nil;
+    _pageGroup = dispatch_group_create();
+    _pageSemaphore = dispatch_semaphore_create([[NSProcessInfo processInfo] activeProcessorCount]);
+
+    if (multipleModules) {
+        // Only the index of modules is held until the report ends; each module's page is written as it is reported
         NSMutableString *html = [[NSMutableString alloc] init];
 
         [html appendString:@"<html>\n<head>\n"];
@@ -56,75 +82,120 @@
             [html appendFormat:@"\n<h1>%@</h1>\n", title];
         }
 
-        for (OCDModule *module in differences.modules) {
-            if (module.differenceType == OCDifferenceTypeRemoval) {
-                if (hasDifferences == NO) {
-                    hasDifferences = YES;
-                    [html appendString:@"\n<ul>\n"];
-                }
-                [html appendFormat:@"<li>%@ <span class=\"status removed\">(Removed)</span></li>\n", module.name];
-                continue;
-            } else if (module.differences.count < 1) {
-                continue;
-            } else {
-                if (hasDifferences == NO) {
-                    hasDifferences = YES;
-                    [html appendString:@"\n<ul>\n"];
-                }
-                [html appendFormat:@"<li><a href=\"%@.html\">%@</a>", module.name, module.name];
-                if (module.differenceType == OCDifferenceTypeAddition) {
-                    [html appendString:@" <span class=\"status added\">(Added)</span>"];
-                }
-                [html appendString:@"</li>\n"];
-            }
+        _indexHTML = html;
+    }
+}
 
-            NSString *moduleTitle;
-            if (title != nil) {
-                moduleTitle = [NSString stringWithFormat:@"%@ %@", module.name, title ?: @""];
-            } else {
-                moduleTitle = module.name;
-            }
+- (void)reportModule:(OCDModule *)module {
+    NSString *title = _title;
+    NSString *outputFile;
 
-            NSString *fileName = [module.name stringByAppendingPathExtension:@"html"];
-            outputFile = [_outputDirectory stringByAppendingPathComponent:fileName];
-            [self generateFileForDifferences:module.differences title:moduleTitle path:outputFile];
-        }
+    if (_multipleModules == NO) {
+        outputFile = [_outputDirectory stringByAppendingPathComponent:@"apidiff.html"];
+        [self generateFileForDifferences:module.differences title:title path:outputFile];
+        return;
+    }
 
-        if (hasDifferences) {
-            [html appendString:@"</ul>\n"];
-        } else {
-            [html appendString:@"<div class=\"message\">No differences</div>\n"];
+    NSMutableString *html = _indexHTML;
+
+    if (module.differenceType == OCDifferenceTypeRemoval) {
+        if (_hasDifferences == NO) {
+            _hasDifferences = YES;
+            [html appendString:@"\n<ul>\n"];
+        }
+        [html appendFormat:@"<li>%@ <span class=\"status removed\">(Removed)</span></li>\n", module.name];
+        return;
+    } else if (module.differences.count < 1) {
+        return;
+    } else {
+        if (_hasDifferences == NO) {
+            _hasDifferences = YES;
+            [html appendString:@"\n<ul>\n"];
+        }
+        [html appendFormat:@"<li><a href=\"%@.html\">%@</a>", module.name, module.name];
+        if (module.differenceType == OCDifferenceTypeAddition) {
+            [html appendString:@" <span class=\"status added\">(Added)</span>"];
         }
+        [html appendString:@"</li>\n"];
+    }
+
+    NSString *moduleTitle;
+    if (title != nil) {
+        moduleTitle = [NSString stringWithFormat:@"%@ %@", module.name, title ?: @""];
+    } else {
+        moduleTitle = module.name;
+    }
 
-        [html appendString:@"</body>\n</html>\n"];
+    NSString *fileName = [module.name stringByAppendingPathExtension:@"html"];
+    outputFile = [_outputDirectory stringByAppendingPathComponent:fileName];
 
-        outputFile = [_outputDirectory stringByAppendingPathComponent:@"index.html"];
-        if (![html writeToFile:outputFile atomically:NO encoding:NSUTF8StringEncoding error:&error]) {
-            fprintf(stderr, "Error writing HTML report to %s: %s\n", [outputFile UTF8String], [[error description] UTF8String]);
-            exit(1);
+    // Each page depends only on its own module, so pages are identical whatever order they are written in
+    dispatch_semaphore_t semaphore = _pageSemaphore;
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    dispatch_group_async(_pageGroup, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        @autoreleasepool {
+            [self generateFileForDifferences:module.differences title:moduleTitle path:outputFile];
         }
+
+        dispatch_semaphore_signal(semaphore);
+    });
+}
+
+- (void)endReport {
+    if (_multipleModules == NO) {
+        return;
+    }
+
+    dispatch_group_wait(_pageGroup, DISPATCH_TIME_FOREVER);
+
+    NSMutableString *html = _indexHTML;
+
+    if (_hasDifferences) {
+        [html appendString:@"</ul>\n"];
+    } else {
+        [html appendString:@"<div class=\"message\">No differences</div>\n"];
+    }
+
+    [html appendString:@"</body>\n</html>\n"];
+
+    NSError *error;
+    NSString *outputFile = [_outputDirectory stringByAppendingPathComponent:@"index.html"];
+    if (![html writeToFile:outputFile atomically:NO encoding:NSUTF8StringEncoding error:&error]) {
+        fprintf(stderr, "Error writing HTML report to %s: %s\n", [outputFile UTF8String], [[error description] UTF8String]);
+        exit(1);
     }
+
+    _indexHTML = nil;
 }
 
 - (void)generateFileForDifferences:(NSArray<OCDifference *> *)differences title:(NSString *)title path:(NSString *)outputFile {
-    NSMutableString *html = [[NSMutableString alloc] init];
+    NSError *error;
+    OCDBufferedWriter *writer = [OCDBufferedWriter writerWithPath:outputFile error:&error];
+    if (writer == nil) {
+        fprintf(stderr, "Error writing HTML report to %s: %s\n", [outputFile UTF8String], [[error description] UTF8String]);
+        exit(1);
+    }
 
-    [html appendString:@"<html>\n<head>\n"];
+    [writer writeUTF8String:"<html>\n<head>\n"];
 
     if (title != nil) {
-        [html appendFormat:@"<title>%@</title>\n", title];
+        [writer writeUTF8String:"<title>"];
+        [writer writeString:title];
+        [writer writeUTF8String:"</title>\n"];
     }
 
-    [html appendString:@"<link rel=\"stylesheet\" href=\"apidiff.css\" type=\"text/css\" />\n"];
-    [html appendString:@"<meta charset=\"utf-8\" />\n"];
-    [html appendString:@"</head>\n<body>\n"];
+    [writer writeUTF8String:"<link rel=\"stylesheet\" href=\"apidiff.css\" type=\"text/css\" />\n"];
+    [writer writeUTF8String:"<meta charset=\"utf-8\" />\n"];
+    [writer writeUTF8String:"</head>\n<body>\n"];
 
     if (title != nil) {
-        [html appendFormat:@"\n<h1>%@</h1>\n", title];
+        [writer writeUTF8String:"\n<h1>"];
+        [writer writeString:title];
+        [writer writeUTF8String:"</h1>\n"];
     }
 
     if ([differences count] == 0) {
-        [html appendString:@"<div class=\"message\">No differences</div>\n"];
+        [writer writeUTF8String:"<div class=\"message\">No differences</div>\n"];
     }
 
     NSString *lastFile = @"";
@@ -136,15 +207,17 @@
         if ([file isEqualToString:lastFile] == NO) {
             if ([lastFile length] > 0) {
                 if (typeCount > 0) {
-                    [html appendString:@"</div>\n\n"];
+                    [writer writeUTF8String:"</div>\n\n"];
                     typeCount = 0;
                 }
 
-                [html appendString:@"</div>\n"];
+                [writer writeUTF8String:"</div>\n"];
             }
 
-            [html appendString:@"\n<div class=\"headerFile\">\n"];
-            [html appendFormat:@"<div class=\"headerName\">%@</div>\n", file];
+            [writer writeUTF8String:"\n<div class=\"headerFile\">\n"];
+            [writer writeUTF8String:"<div class=\"headerName\">"];
+            [writer writeString:file];
+            [writer writeUTF8String:"</div>\n"];
 
             lastFile = file;
             lastType = NSUIntegerMax;
@@ -152,13 +225,13 @@
 
         if (difference.type != lastType) {
             if (typeCount > 0) {
-                [html appendString:@"</div>\n\n"];
+                [writer writeUTF8String:"</div>\n\n"];
                 typeCount = 0;
             }
 
             lastType = difference.type;
 
-            [html appendFormat:@"\n<div class=\"differenceGroup\">\n"];
+            [writer writeUTF8String:"\n<div class=\"differenceGroup\">\n"];
         }
 
 
@@ -167,84 +240,100 @@
             link = [_linkMap URLForUSR:difference.USR];
         }
 
-        [html appendFormat:@"<div class=\"difference\"><span class=\"status %@\">%@</span> ", [[self stringForDifferenceType:difference.type] lowercaseString], [self stringForDifferenceType:difference.type]];
+        NSString *typeName = [self stringForDifferenceType:difference.type];
+        [writer writeUTF8String:"<div class=\"difference\"><span class=\"status "];
+        [writer writeString:[typeName lowercaseString]];
+        [writer writeUTF8String:"\">"];
+        [writer writeString:typeName];
+        [writer writeUTF8String:"</span> "];
 
         if (link != nil) {
-            [html appendFormat:@"<a href=\"%@\">", link];
+            [writer writeUTF8String:"<a href=\""];
+            [writer writeString:[link description]];
+            [writer writeUTF8String:"\">"];
         }
 
-        [html appendFormat:@"%@", difference.name];
+        [writer writeString:difference.name];
 
         if (link != nil) {
-            [html appendFormat:@"</a>"];
+            [writer writeUTF8String:"</a>"];
         }
 
-        [html appendFormat:@"</div>\n"];
+        [writer writeUTF8String:"</div>\n"];
 
         if ([difference.modifications count] > 0) {
-            [html appendString:@"<table>\n"];
+            [writer writeUTF8String:"<table>\n"];
 
             // Header
-            [html appendString:@"<tr><th></th>"];
+            [writer writeUTF8String:"<tr><th></th>"];
 
             for (OCDModification *modification in difference.modifications) {
-                [html appendFormat:@"<th>%@</th>", [OCDModification stringForModificationType:modification.type]];
+                [writer writeUTF8String:"<th>"];
+                [writer writeString:[OCDModification stringForModificationType:modification.type]];
+                [writer writeUTF8String:"</th>"];
             }
 
-            [html appendString:@"</tr>\n"];
+            [writer writeUTF8String:"</tr>\n"];
 
             // From
-            [html appendString:@"<tr><th>From</th>"];
+            [writer writeUTF8String:"<tr><th>From</th>"];
 
             for (OCDModification *modification in difference.modifications) {
-                [html appendFormat:@"<td%@>%@</td>", [self isDeclarationType:modification.type] ? @" class=\"declaration\"" : @"", [modification.previousValue length] > 0 ? [self stringByHTMLEscapingString:modification.previousValue] : @"<em>none</em>"];
+                [self writeModificationValue:modification.previousValue type:modification.type toWriter:writer];
             }
 
-            [html appendString:@"</tr>\n"];
+            [writer writeUTF8String:"</tr>\n"];
 
             // To
-            [html appendString:@"<tr><th>To</th>"];
+            [writer writeUTF8String:"<tr><th>To</th>"];
 
             for (OCDModification *modification in difference.modifications) {
-                [html appendFormat:@"<td%@>%@</td>", [self isDeclarationType:modification.type] ? @" class=\"declaration\"" : @"", [modification.currentValue length] > 0 ? [self stringByHTMLEscapingString:modification.currentValue] : @"<em>none</em>"];
+                [self writeModificationValue:modification.currentValue type:modification.type toWriter:writer];
             }
 
-            [html appendString:@"</tr>\n"];
+            [writer writeUTF8String:"</tr>\n"];
 
-            [html appendString:@"</table>\n"];
-            [html appendString:@"<br>\n"];
+            [writer writeUTF8String:"</table>\n"];
+            [writer writeUTF8String:"<br>\n"];
         }
 
         typeCount++;
     }
 
     if (typeCount > 0) {
-        [html appendString:@"</div>\n\n"];
+        [writer writeUTF8String:"</div>\n\n"];
     }
 
     if ([lastFile length] > 0) {
-        [html appendString:@"</div>\n"];
+        [writer writeUTF8String:"</div>\n"];
     }
 
-    [html appendString:@"</body>\n</html>\n"];
+    [writer writeUTF8String:"</body>\n</html>\n"];
 
-    NSError *error;
-    if (![html writeToFile:outputFile atomically:NO encoding:NSUTF8StringEncoding error:&error]) {
+    if (![writer close:&error]) {
         fprintf(stderr, "Error writing HTML report to %s: %s\n", [outputFile UTF8String], [[error description] UTF8String]);
         exit(1);
     }
 }
 
+- (void)writeModificationValue:(NSString *)value type:(OCDModificationType)type toWriter:(OCDBufferedWriter *)writer {
+    [writer writeUTF8String:[self isDeclarationType:type] ? "<td class=\"declaration\">" : "<td>"];
+
+    if ([value length] > 0) {
+        [writer writeEscapedString:value];
+    } else {
+        [writer writeUTF8String:"<em>none</em>"];
+    }
+
+    [writer writeUTF8String:"</td>"];
+}
+
 - (NSData *)embeddedResouceDataWithName:(NSString *)name {
     unsigned long size = 0;
     uint8_t *data = getsectiondata(&_mh_execute_header, "__TEXT", [name UTF8String], &size);
     return data ? [NSData dataWithBytesNoCopy:data length:size freeWhenDone:NO] : nil;
 }
 
-- (NSString *)stringByHTMLEscapingString:(NSString *)string {
-    return CFBridgingRelease(CFXMLCreateStringByEscapingEntities(kCFAllocatorDefault, (__bridge CFStringRef)string, NULL));
-}
-
 - (NSString *)stringForDifferenceType:(OCDifferenceType)type {
     switch (type) {
         case OCDifferenceTypeAddition:
@@ -0,0 +1,9 @@
+#import <Foundation/Foundation.h>
+
+/**
+ * Returns a fast, non-cryptographic 64-bit hash of the specified bytes.
+ *
+ * The hash is XXH64, which processes input in four independent 64-bit lanes so that several multiply-rotate rounds
+ * are in flight at once. It is suitable for detecting changed content, but not for resisting deliberate collisions.
+ */
+FOUNDATION_EXPORT uint64_t OCDHash64(const void *bytes, size_t length, uint64_t seed);
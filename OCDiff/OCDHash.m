@@ -0,0 +1,93 @@
+#import "OCDHash.h"
+
+static const uint64_t OCDHashPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t OCDHashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t OCDHashPrime3 = 0x165667B19E3779F9ULL;
+static const uint64_t OCDHashPrime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t OCDHashPrime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t OCDHashRotateLeft(uint64_t value, int count) {
+    return (value << count) | (value >> (64 - count));
+}
+
+static inline uint64_t OCDHashRead64(const uint8_t *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt64LittleToHost(value);
+}
+
+static inline uint32_t OCDHashRead32(const uint8_t *bytes) {
+    uint32_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return CFSwapInt32LittleToHost(value);
+}
+
+static inline uint64_t OCDHashRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * OCDHashPrime2;
+    accumulator = OCDHashRotateLeft(accumulator, 31);
+    return accumulator * OCDHashPrime1;
+}
+
+static inline uint64_t OCDHashMergeRound(uint64_t accumulator, uint64_t value) {
+    accumulator ^= OCDHashRound(0, value);
+    return accumulator * OCDHashPrime1 + OCDHashPrime4;
+}
+
+uint64_t OCDHash64(const void *bytes, size_t length, uint64_t seed) {
+    const uint8_t *p = bytes;
+    const uint8_t *end = p + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        // Each 32-byte stripe feeds one word to each of the four lanes, which are independent until merged
+        const uint8_t *limit = end - 32;
+        uint64_t v1 = seed + OCDHashPrime1 + OCDHashPrime2;
+        uint64_t v2 = seed + OCDHashPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - OCDHashPrime1;
+
+        do {
+            v1 = OCDHashRound(v1, OCDHashRead64(p));
+            v2 = OCDHashRound(v2, OCDHashRead64(p + 8));
+            v3 = OCDHashRound(v3, OCDHashRead64(p + 16));
+            v4 = OCDHashRound(v4, OCDHashRead64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = OCDHashRotateLeft(v1, 1) + OCDHashRotateLeft(v2, 7) + OCDHashRotateLeft(v3, 12) + OCDHashRotateLeft(v4, 18);
+        hash = OCDHashMergeRound(hash, v1);
+        hash = OCDHashMergeRound(hash, v2);
+        hash = OCDHashMergeRound(hash, v3);
+        hash = OCDHashMergeRound(hash, v4);
+    } else {
+        hash = seed + OCDHashPrime5;
+    }
+
+    hash += (uint64_t)length;
+
+    while (p + 8 <= end) {
+        hash ^= OCDHashRound(0, OCDHashRead64(p));
+        hash = OCDHashRotateLeft(hash, 27) * OCDHashPrime1 + OCDHashPrime4;
+        p += 8;
+    }
+
+    if (p + 4 <= end) {
+        hash ^= (uint64_t)OCDHashRead32(p) * OCDHashPrime1;
+        hash = OCDHashRotateLeft(hash, 23) * OCDHashPrime2 + OCDHashPrime3;
+        p += 4;
+    }
+
+    while (p < end) {
+        hash ^= (*p) * OCDHashPrime5;
+        hash = OCDHashRotateLeft(hash, 11) * OCDHashPrime1;
+        p++;
+    }
+
+    hash ^= hash >> 33;
+    hash *= OCDHashPrime2;
+    hash ^= hash >> 29;
+    hash *= OCDHashPrime3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
@@ -11,7 +11,7 @@ typedef NS_ENUM(NSUInteger, OCDModificationType) {
     OCDModificationTypeHeader
 };
 
-@interface OCDModification : NSObject
+@interface OCDModification : NSObject <NSSecureCoding>
 
 + (instancetype)modificationWithType:(OCDModificationType)type previousValue:(NSString *)previousValue currentValue:(NSString *)currentValue;
 
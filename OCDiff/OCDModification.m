@@ -17,6 +17,22 @@
     return [[self alloc] initWithType:type previousValue:previousValue currentValue:currentValue];
 }
 
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)coder {
+    return [self initWithType:(OCDModificationType)[coder decodeIntegerForKey:@"type"]
+                previousValue:[coder decodeObjectOfClass:[NSString class] forKey:@"previousValue"]
+                 currentValue:[coder decodeObjectOfClass:[NSString class] forKey:@"currentValue"]];
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [coder encodeInteger:_type forKey:@"type"];
+    [coder encodeObject:_previousValue forKey:@"previousValue"];
+    [coder encodeObject:_currentValue forKey:@"currentValue"];
+}
+
 + (NSString *)stringForModificationType:(OCDModificationType)type {
     switch (type) {
         case OCDModificationTypeDeclaration:
@@ -1,7 +1,7 @@
 #import <Foundation/Foundation.h>
 #import "OCDifference.h"
 
-@interface OCDModule : NSObject
+@interface OCDModule : NSObject <NSSecureCoding>
 
 + (instancetype)moduleWithName:(NSString *)name differenceType:(OCDifferenceType)differenceType differences:(NSArray<OCDifference *> *)differences;
 
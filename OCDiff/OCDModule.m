@@ -17,4 +17,21 @@
     return [[self alloc] initWithName:name differenceType:differenceType differences:differences];
 }
 
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)coder {
+    NSSet *differenceClasses = [NSSet setWithObjects:[NSArray class], [OCDifference class], nil];
+    return [self initWithName:[coder decodeObjectOfClass:[NSString class] forKey:@"name"]
+               differenceType:(OCDifferenceType)[coder decodeIntegerForKey:@"differenceType"]
+                  differences:[coder decodeObjectOfClasses:differenceClasses forKey:@"differences"]];
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [coder encodeObject:_name forKey:@"name"];
+    [coder encodeInteger:_differenceType forKey:@"differenceType"];
+    [coder encodeObject:_differences forKey:@"differences"];
+}
+
 @end
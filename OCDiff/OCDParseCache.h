@@ -0,0 +1,54 @@
+#import <Foundation/Foundation.h>
+#import "OCDAPISnapshot.h"
+#import "OCDCache.h"
+#import "OCDSDK.h"
+
+/**
+ * A cache of the APIs extracted from parsed header sets, stored as API snapshots.
+ *
+ * An entry is keyed by the contents of everything that determines the parse result: the paths and bytes of the
+ * files the headers may include, the generated umbrella source that imports them, the compiler arguments, and the
+ * SDK. An API whose headers have not changed since a previous run is loaded from its snapshot rather than parsed.
+ *
+ * Headers reached through search paths specified by the user in addition to those of the API itself are identified
+ * only by the compiler arguments that locate them, so a change to such a header is not detected.
+ */
+@interface OCDParseCache : NSObject
+
+- (instancetype)initWithCache:(OCDCache *)cache;
+
+/**
+ * Returns the key for the API parsed from the specified source and headers.
+ *
+ * @param headerPaths The absolute paths of the files the source may include, directly or indirectly.
+ * @param sdk The SDK the headers are parsed with. Its version is included in the key because an SDK may be updated
+ * in place.
+ * @return The key, or nil if a header could not be read.
+ */
++ (NSString *)keyForSource:(NSString *)source headerPaths:(NSArray<NSString *> *)headerPaths compilerArguments:(NSArray<NSString *> *)compilerArguments SDK:(OCDSDK *)sdk;
+
+/**
+ * Returns the snapshot stored for the specified key, or nil if there is none, and records a hit or miss accordingly.
+ *
+ * A corrupt entry is discarded and counted as a miss. This method is thread-safe.
+ */
+- (OCDAPISnapshot *)snapshotForKey:(NSString *)key;
+
+/**
+ * Stores the snapshot of a parsed API for the specified key.
+ *
+ * This method is thread-safe.
+ */
+- (BOOL)storeSnapshot:(OCDAPISnapshot *)snapshot forKey:(NSString *)key error:(NSError **)error;
+
+/**
+ * The number of lookups that returned a snapshot.
+ */
+@property (nonatomic, readonly) NSUInteger hitCount;
+
+/**
+ * The number of lookups that did not return a snapshot.
+ */
+@property (nonatomic, readonly) NSUInteger missCount;
+
+@end
@@ -0,0 +1,86 @@
+#import "OCDParseCache.h"
+#import <ObjectDoc/PLClang.h>
+
+static NSString * const OCDParseCacheExtension = @"ocdsnapshot";
+
+@implementation OCDParseCache {
+    OCDCache *_cache;
+    NSUInteger _hitCount;
+    NSUInteger _missCount;
+}
+
+- (instancetype)initWithCache:(OCDCache *)cache {
+    if (!(self = [super init]))
+        return nil;
+
+    _cache = cache;
+
+    return self;
+}
+
++ (NSString *)keyForSource:(NSString *)source headerPaths:(NSArray<NSString *> *)headerPaths compilerArguments:(NSArray<NSString *> *)compilerArguments SDK:(OCDSDK *)sdk {
+    // The snapshot format version is included so that entries written by an older version are never read
+    NSMutableArray *components = [NSMutableArray arrayWithObjects:
+                                  @"parse",
+                                  [NSString stringWithFormat:@"%u", OCDAPISnapshotVersion],
+                                  PLClangGetVersionString(),
+                                  sdk.version ?: @"",
+                                  sdk.platformBuild ?: @"",
+                                  source,
+                                  nil];
+
+    [components addObject:[NSString stringWithFormat:@"%lu", (unsigned long)[compilerArguments count]]];
+    [components addObjectsFromArray:compilerArguments];
+
+    for (NSString *path in [headerPaths sortedArrayUsingSelector:@selector(compare:)]) {
+        NSData *contents = [NSData dataWithContentsOfFile:path options:NSDataReadingMappedIfSafe error:NULL];
+        if (contents == nil) {
+            return nil;
+        }
+
+        [components addObject:path];
+        [components addObject:contents];
+    }
+
+    return [OCDCache keyForComponents:components];
+}
+
+- (OCDAPISnapshot *)snapshotForKey:(NSString *)key {
+    OCDAPISnapshot *snapshot = nil;
+
+    NSString *path = [_cache pathForKey:key extension:OCDParseCacheExtension];
+    if (path != nil) {
+        snapshot = [OCDAPISnapshot snapshotWithContentsOfFile:path error:NULL];
+        if (snapshot == nil) {
+            [_cache removeEntryForKey:key extension:OCDParseCacheExtension];
+        }
+    }
+
+    @synchronized (self) {
+        if (snapshot != nil) {
+            _hitCount++;
+        } else {
+            _missCount++;
+        }
+    }
+
+    return snapshot;
+}
+
+- (BOOL)storeSnapshot:(OCDAPISnapshot *)snapshot forKey:(NSString *)key error:(NSError **)error {
+    return [_cache storeData:snapshot.data forKey:key extension:OCDParseCacheExtension error:error] != nil;
+}
+
+- (NSUInteger)hitCount {
+    @synchronized (self) {
+        return _hitCount;
+    }
+}
+
+- (NSUInteger)missCount {
+    @synchronized (self) {
+        return _missCount;
+    }
+}
+
+@end
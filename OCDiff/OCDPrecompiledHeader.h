@@ -0,0 +1,69 @@
+#import <Foundation/Foundation.h>
+
+/**
+ * A precompiled header that can be shared by many translation units parsed with the same compiler arguments.
+ *
+ * A precompiled header may be chained onto a parent, in which case it contains only the declarations its source
+ * adds on top of the parent's. Including it includes the entire chain.
+ *
+ * The precompiled header is written to a temporary file that is removed when the object is deallocated.
+ */
+@interface OCDPrecompiledHeader : NSObject
+
+/**
+ * Parses the specified source and writes it to a new precompiled header.
+ *
+ * Returns nil if the source could not be parsed or the precompiled header could not be written.
+ */
++ (instancetype)precompiledHeaderWithSource:(NSString *)source compilerArguments:(NSArray *)compilerArguments error:(NSError **)error;
+
+/**
+ * Parses the specified source on top of a parent precompiled header and writes it to a new chained precompiled
+ * header.
+ *
+ * @param compilerArguments The arguments the parent was built with.
+ */
++ (instancetype)precompiledHeaderWithSource:(NSString *)source compilerArguments:(NSArray *)compilerArguments parent:(OCDPrecompiledHeader *)parent error:(NSError **)error;
+
+/**
+ * Returns the specified compiler arguments with the arguments required to include the precompiled header.
+ *
+ * The precompiled header may only be included by translation units parsed with the arguments it was built with.
+ */
+- (NSArray *)compilerArgumentsByAddingToArguments:(NSArray *)compilerArguments;
+
+/**
+ * Returns a Boolean value indicating whether the precompiled header or any of its ancestors contain declarations
+ * from headers within the specified directory.
+ *
+ * Declarations from the precompiled header are not visited when the index excludes PCH declarations, so an API
+ * whose headers are part of the precompiled header must be parsed without it.
+ */
+- (BOOL)containsHeadersInDirectory:(NSString *)path;
+
+/**
+ * Records that a translation unit was successfully parsed with the precompiled header included.
+ *
+ * This method is thread-safe.
+ */
+- (void)recordUse;
+
+@property (nonatomic, readonly) NSString *path;
+@property (nonatomic, readonly) OCDPrecompiledHeader *parent;
+
+/**
+ * The number of headers that the precompiled header adds on top of its parent.
+ */
+@property (nonatomic, readonly) NSUInteger headerCount;
+
+/**
+ * The time taken to parse and write the precompiled header, excluding the time taken to build its parent.
+ */
+@property (nonatomic, readonly) NSTimeInterval buildTime;
+
+/**
+ * The number of translation units that have been parsed with the precompiled header included.
+ */
+@property (nonatomic, readonly) NSUInteger useCount;
+
+@end
@@ -0,0 +1,142 @@
+#import "OCDPrecompiledHeader.h"
+#import <ObjectDoc/ObjectDoc.h>
+#import <ObjectDoc/PLClang.h>
+
+@implementation OCDPrecompiledHeader {
+    NSString *_directory;
+    NSArray *_headerPaths;
+    NSUInteger _useCount;
+}
+
+- (instancetype)initWithDirectory:(NSString *)directory parent:(OCDPrecompiledHeader *)parent headerPaths:(NSSet *)headerPaths buildTime:(NSTimeInterval)buildTime {
+    if (!(self = [super init]))
+        return nil;
+
+    _directory = [directory copy];
+    _path = [directory stringByAppendingPathComponent:@"_OCDPreamble.pch"];
+    _parent = parent;
+    _headerPaths = [[headerPaths allObjects] sortedArrayUsingSelector:@selector(compare:)];
+    _buildTime = buildTime;
+
+    return self;
+}
+
+- (void)dealloc {
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:NULL];
+}
+
++ (instancetype)precompiledHeaderWithSource:(NSString *)source compilerArguments:(NSArray *)compilerArguments error:(NSError **)error {
+    return [self precompiledHeaderWithSource:source compilerArguments:compilerArguments parent:nil error:error];
+}
+
++ (instancetype)precompiledHeaderWithSource:(NSString *)source compilerArguments:(NSArray *)compilerArguments parent:(OCDPrecompiledHeader *)parent error:(NSError **)error {
+    NSDate *startDate = [NSDate date];
+    NSString *directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"objc-diff-%@", [[NSUUID UUID] UUIDString]]];
+    if ([[NSFileManager defaultManager] createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:error] == NO) {
+        return nil;
+    }
+
+    // Only the declarations added on top of the parent need to be visited to determine the headers this
+    // precompiled header adds
+    PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:(parent ? PLClangIndexCreationExcludePCHDeclarations : 0)];
+    NSString *sourcePath = [directory stringByAppendingPathComponent:@"_OCDPreamble.h"];
+    PLClangUnsavedFile *unsavedFile = [PLClangUnsavedFile unsavedFileWithPath:sourcePath
+                                                                         data:[source dataUsingEncoding:NSUTF8StringEncoding]];
+
+    if (parent != nil) {
+        compilerArguments = [parent compilerArgumentsByAddingToArguments:compilerArguments];
+    }
+
+    PLClangTranslationUnit *translationUnit = [index addTranslationUnitWithSourcePath:sourcePath
+                                                                         unsavedFiles:@[unsavedFile]
+                                                                    compilerArguments:compilerArguments
+                                                                              options:PLClangTranslationUnitCreationDetailedPreprocessingRecord |
+                                                                                      PLClangTranslationUnitCreationSkipFunctionBodies |
+                                                                                      PLClangTranslationUnitCreationIncomplete |
+                                                                                      PLClangTranslationUnitCreationForSerialization
+                                                                                error:error];
+
+    if (translationUnit != nil && translationUnit.didFail) {
+        NSString *description = @"Failed to parse the precompiled header source";
+        for (PLClangDiagnostic *diagnostic in translationUnit.diagnostics) {
+            if (diagnostic.severity >= PLClangDiagnosticSeverityError) {
+                description = diagnostic.formattedErrorMessage;
+                break;
+            }
+        }
+
+        if (error != NULL) {
+            *error = [NSError errorWithDomain:PLClangErrorDomain code:PLClangErrorCompiler userInfo:@{NSLocalizedDescriptionKey: description}];
+        }
+
+        translationUnit = nil;
+    }
+
+    OCDPrecompiledHeader *precompiledHeader = nil;
+
+    if (translationUnit != nil) {
+        NSMutableSet *headerPaths = [NSMutableSet set];
+        [translationUnit.cursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
+            NSString *path = cursor.location.path;
+            if (path != nil) {
+                [headerPaths addObject:path];
+            }
+
+            return PLClangCursorVisitContinue;
+        }];
+
+        NSString *path = [directory stringByAppendingPathComponent:@"_OCDPreamble.pch"];
+        if ([translationUnit writeToFile:path error:error]) {
+            NSTimeInterval buildTime = -[startDate timeIntervalSinceNow];
+            precompiledHeader = [[self alloc] initWithDirectory:directory parent:parent headerPaths:headerPaths buildTime:buildTime];
+        }
+    }
+
+    if (precompiledHeader == nil) {
+        [[NSFileManager defaultManager] removeItemAtPath:directory error:NULL];
+    }
+
+    return precompiledHeader;
+}
+
+- (NSArray *)compilerArgumentsByAddingToArguments:(NSArray *)compilerArguments {
+    return [compilerArguments arrayByAddingObjectsFromArray:@[@"-include-pch", _path]];
+}
+
+- (BOOL)containsHeadersInDirectory:(NSString *)path {
+    if ([path hasSuffix:@"/"] == NO) {
+        path = [path stringByAppendingString:@"/"];
+    }
+
+    // Header paths are sorted, so any path within the directory sorts at or after the directory itself
+    NSUInteger index = [_headerPaths indexOfObject:path
+                                     inSortedRange:NSMakeRange(0, [_headerPaths count])
+                                           options:NSBinarySearchingInsertionIndex | NSBinarySearchingFirstEqual
+                                   usingComparator:^NSComparisonResult(NSString *obj1, NSString *obj2) {
+                                       return [obj1 compare:obj2];
+                                   }];
+
+    if (index < [_headerPaths count] && [_headerPaths[index] hasPrefix:path]) {
+        return YES;
+    }
+
+    return [_parent containsHeadersInDirectory:path];
+}
+
+- (NSUInteger)headerCount {
+    return [_headerPaths count];
+}
+
+- (void)recordUse {
+    @synchronized (self) {
+        _useCount++;
+    }
+}
+
+- (NSUInteger)useCount {
+    @synchronized (self) {
+        return _useCount;
+    }
+}
+
+@end
@@ -3,6 +3,32 @@
 
 @protocol OCDReportGenerator <NSObject>
 
+/**
+ * Generates a report for a complete set of differences.
+ *
+ * Equivalent to beginning a report, reporting each module in turn, and ending the report.
+ */
 - (void)generateReportForDifferences:(OCDAPIDifferences *)differences title:(NSString *)title;
 
+/**
+ * Begins an incremental report.
+ *
+ * Modules are then reported one at a time in report order with -reportModule:, so that a module's differences may
+ * be released as soon as they have been written.
+ *
+ * @param multipleModules Whether the report covers multiple modules, such as the frameworks of an SDK, rather than
+ * a single API.
+ */
+- (void)beginReportWithTitle:(NSString *)title multipleModules:(BOOL)multipleModules;
+
+/**
+ * Adds a module to the report begun with -beginReportWithTitle:multipleModules:.
+ */
+- (void)reportModule:(OCDModule *)module;
+
+/**
+ * Completes the report begun with -beginReportWithTitle:multipleModules:.
+ */
+- (void)endReport;
+
 @end
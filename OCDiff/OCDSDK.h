@@ -29,4 +29,15 @@ typedef NS_ENUM(NSUInteger, OCDPlatform) {
 @property (nonatomic, readonly) NSString *deploymentTargetEnvironmentVariable;
 @property (nonatomic, readonly) NSString *defaultArchitecture;
 
+/**
+ * Returns the specified compiler arguments with occurrences of the SDK's path replaced by a placeholder, so that the
+ * arguments used to parse two SDKs can be compared.
+ *
+ * The deployment target and API_TO_BE_DEPRECATED arguments derived from the SDK are kept: API_TO_BE_DEPRECATED
+ * expands into the deprecation versions of declarations, and older availability macros declare deprecations only
+ * for deployment targets at or after the deprecating release, so the same headers may produce different APIs for
+ * different deployment targets.
+ */
+- (NSArray<NSString *> *)compilerArgumentsIndependentOfSDK:(NSArray<NSString *> *)compilerArguments;
+
 @end
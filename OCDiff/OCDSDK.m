@@ -128,6 +128,17 @@ static NSString * const ArchARM64 = @"arm64";
     return nil;
 }
 
+- (NSArray<NSString *> *)compilerArgumentsIndependentOfSDK:(NSArray<NSString *> *)compilerArguments {
+    NSString *sdkPath = [self.path stringByStandardizingPath];
+
+    NSMutableArray<NSString *> *arguments = [NSMutableArray arrayWithCapacity:[compilerArguments count]];
+    for (NSString *argument in compilerArguments) {
+        [arguments addObject:[argument stringByReplacingOccurrencesOfString:sdkPath withString:@"$(SDKROOT)"]];
+    }
+
+    return arguments;
+}
+
 - (NSString *)description {
     return self.name;
 }
@@ -0,0 +1,51 @@
+#import <Foundation/Foundation.h>
+#import "OCDModule.h"
+
+/**
+ * A record of the module produced for each framework by a previous SDK comparison, along with the inputs it was
+ * computed from.
+ *
+ * Inputs are opaque strings, such as the hashes of the headers a framework's parse depends on and of the compiler
+ * arguments, keyed by name. A stored module is only returned for a framework whose current inputs are identical to
+ * those it was computed from.
+ */
+@interface OCDSDKManifest : NSObject
+
+/**
+ * Returns a manifest read from data previously returned by -data, or nil if the data is not a valid manifest.
+ */
++ (instancetype)manifestWithData:(NSData *)data error:(NSError **)error;
+
+/**
+ * Returns a Boolean value indicating whether a module is stored for the specified framework that was computed from
+ * the specified inputs. The module itself is not decoded.
+ *
+ * This method is thread-safe.
+ */
+- (BOOL)hasModuleForFramework:(NSString *)frameworkName inputs:(NSDictionary<NSString *, NSString *> *)inputs;
+
+/**
+ * Returns the module stored for the specified framework if it was computed from the specified inputs, otherwise nil.
+ *
+ * This method is thread-safe.
+ */
+- (OCDModule *)moduleForFramework:(NSString *)frameworkName inputs:(NSDictionary<NSString *, NSString *> *)inputs;
+
+/**
+ * Stores the module computed for the specified framework from the specified inputs, replacing any existing entry.
+ *
+ * This method is thread-safe.
+ */
+- (void)setModule:(OCDModule *)module inputs:(NSDictionary<NSString *, NSString *> *)inputs forFramework:(NSString *)frameworkName;
+
+/**
+ * Returns an archive of the manifest.
+ */
+- (NSData *)data;
+
+/**
+ * The number of frameworks with a stored module.
+ */
+@property (nonatomic, readonly) NSUInteger frameworkCount;
+
+@end
@@ -0,0 +1,128 @@
+#import "OCDSDKManifest.h"
+
+static NSString * const OCDSDKManifestModuleKey = @"module";
+static NSString * const OCDSDKManifestInputsKey = @"inputs";
+
+@implementation OCDSDKManifest {
+    NSMutableDictionary<NSString *, NSDictionary *> *_entries;
+}
+
+- (instancetype)init {
+    return [self initWithEntries:[NSMutableDictionary dictionary]];
+}
+
+- (instancetype)initWithEntries:(NSMutableDictionary *)entries {
+    if (!(self = [super init]))
+        return nil;
+
+    _entries = entries;
+
+    return self;
+}
+
++ (instancetype)manifestWithData:(NSData *)data error:(NSError **)error {
+    NSDictionary *entries = nil;
+
+    @try {
+        NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:data];
+        unarchiver.requiresSecureCoding = YES;
+        NSSet *classes = [NSSet setWithObjects:[NSDictionary class], [NSString class], [NSData class], nil];
+        entries = [unarchiver decodeObjectOfClasses:classes forKey:NSKeyedArchiveRootObjectKey];
+        [unarchiver finishDecoding];
+    } @catch (NSException *exception) {
+        entries = nil;
+    }
+
+    if ([entries isKindOfClass:[NSDictionary class]] == NO) {
+        if (error != NULL) {
+            *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSFileReadCorruptFileError userInfo:nil];
+        }
+
+        return nil;
+    }
+
+    NSMutableDictionary *validEntries = [NSMutableDictionary dictionaryWithCapacity:[entries count]];
+    for (NSString *frameworkName in entries) {
+        NSDictionary *entry = entries[frameworkName];
+        if ([entry isKindOfClass:[NSDictionary class]] &&
+            [entry[OCDSDKManifestModuleKey] isKindOfClass:[NSData class]] &&
+            [entry[OCDSDKManifestInputsKey] isKindOfClass:[NSDictionary class]]) {
+            validEntries[frameworkName] = entry;
+        }
+    }
+
+    return [[self alloc] initWithEntries:validEntries];
+}
+
+- (NSDictionary *)entryForFramework:(NSString *)frameworkName inputs:(NSDictionary<NSString *, NSString *> *)inputs {
+    NSDictionary *entry;
+    @synchronized (self) {
+        entry = _entries[frameworkName];
+    }
+
+    return [entry[OCDSDKManifestInputsKey] isEqualToDictionary:inputs] ? entry : nil;
+}
+
+- (BOOL)hasModuleForFramework:(NSString *)frameworkName inputs:(NSDictionary<NSString *, NSString *> *)inputs {
+    return [self entryForFramework:frameworkName inputs:inputs] != nil;
+}
+
+- (OCDModule *)moduleForFramework:(NSString *)frameworkName inputs:(NSDictionary<NSString *, NSString *> *)inputs {
+    NSDictionary *entry = [self entryForFramework:frameworkName inputs:inputs];
+    if (entry == nil) {
+        return nil;
+    }
+
+    OCDModule *module = nil;
+
+    @try {
+        NSKeyedUnarchiver *unarchiver = [[NSKeyedUnarchiver alloc] initForReadingWithData:entry[OCDSDKManifestModuleKey]];
+        unarchiver.requiresSecureCoding = YES;
+        module = [unarchiver decodeObjectOfClass:[OCDModule class] forKey:NSKeyedArchiveRootObjectKey];
+        [unarchiver finishDecoding];
+    } @catch (NSException *exception) {
+        module = nil;
+    }
+
+    return module;
+}
+
+- (void)setModule:(OCDModule *)module inputs:(NSDictionary<NSString *, NSString *> *)inputs forFramework:(NSString *)frameworkName {
+    // Modules are held archived so that the manifest does not keep every module's differences alive while an SDK
+    // comparison streams its report
+    NSMutableData *moduleData = [NSMutableData data];
+    NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:moduleData];
+    archiver.requiresSecureCoding = YES;
+    [archiver encodeObject:module forKey:NSKeyedArchiveRootObjectKey];
+    [archiver finishEncoding];
+
+    NSDictionary *entry = @{
+        OCDSDKManifestModuleKey: moduleData,
+        OCDSDKManifestInputsKey: [inputs copy]
+    };
+
+    @synchronized (self) {
+        _entries[frameworkName] = entry;
+    }
+}
+
+- (NSData *)data {
+    NSMutableData *data = [NSMutableData data];
+    NSKeyedArchiver *archiver = [[NSKeyedArchiver alloc] initForWritingWithMutableData:data];
+    archiver.requiresSecureCoding = YES;
+
+    @synchronized (self) {
+        [archiver encodeObject:_entries forKey:NSKeyedArchiveRootObjectKey];
+    }
+
+    [archiver finishEncoding];
+    return data;
+}
+
+- (NSUInteger)frameworkCount {
+    @synchronized (self) {
+        return [_entries count];
+    }
+}
+
+@end
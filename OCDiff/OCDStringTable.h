@@ -0,0 +1,37 @@
+#import <Foundation/Foundation.h>
+
+/**
+ * An identifier for a string in an OCDStringTable.
+ *
+ * Identifiers are assigned in order starting from zero, so two identifiers from the same table are equal if and only
+ * if the strings they identify are equal, and may be used directly as array indexes.
+ */
+typedef uint32_t OCDStringID;
+
+/**
+ * A table of interned strings.
+ *
+ * Strings are stored as UTF-8 bytes in an open-addressed hash table, so interning a string requires neither an
+ * object allocation nor an NSString hash. A single table may be shared by several APIs so that their strings can
+ * be compared as identifiers.
+ */
+@interface OCDStringTable : NSObject
+
+/**
+ * Returns the identifier for the specified UTF-8 bytes, adding them to the table if necessary.
+ */
+- (OCDStringID)identifierForUTF8String:(const char *)string length:(NSUInteger)length;
+
+- (OCDStringID)identifierForString:(NSString *)string;
+
+/**
+ * Returns the string with the specified identifier.
+ */
+- (NSString *)stringForIdentifier:(OCDStringID)identifier;
+
+/**
+ * The number of distinct strings in the table.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+@end
@@ -0,0 +1,105 @@
+#import "OCDStringTable.h"
+#import "OCDHash.h"
+
+/** The value of an unoccupied slot. Occupied slots hold an identifier plus one. */
+static const uint32_t OCDStringTableEmptySlot = 0;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t offset;
+    uint32_t length;
+} OCDStringTableEntry;
+
+@implementation OCDStringTable {
+    NSMutableData *_bytes;
+
+    /** Entries indexed by identifier. */
+    OCDStringTableEntry *_entries;
+    NSUInteger _entryCapacity;
+
+    /** Slots indexed by hash, probed linearly. The slot count is a power of two and at least twice the entry count. */
+    uint32_t *_slots;
+    NSUInteger _slotMask;
+}
+
+- (instancetype)init {
+    if (!(self = [super init]))
+        return nil;
+
+    _bytes = [[NSMutableData alloc] init];
+    _entryCapacity = 64;
+    _entries = malloc(_entryCapacity * sizeof(OCDStringTableEntry));
+    _slotMask = 127;
+    _slots = calloc(_slotMask + 1, sizeof(uint32_t));
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_entries);
+    free(_slots);
+}
+
+- (OCDStringID)identifierForUTF8String:(const char *)string length:(NSUInteger)length {
+    uint64_t hash = OCDHash64(string, length, 0);
+    const uint8_t *bytes = [_bytes bytes];
+    NSUInteger slot = (NSUInteger)hash & _slotMask;
+
+    while (_slots[slot] != OCDStringTableEmptySlot) {
+        const OCDStringTableEntry *entry = &_entries[_slots[slot] - 1];
+        if (entry->hash == hash && entry->length == length && memcmp(bytes + entry->offset, string, length) == 0) {
+            return _slots[slot] - 1;
+        }
+
+        slot = (slot + 1) & _slotMask;
+    }
+
+    OCDStringID identifier = (OCDStringID)_count;
+    if (_count == _entryCapacity) {
+        _entryCapacity *= 2;
+        _entries = realloc(_entries, _entryCapacity * sizeof(OCDStringTableEntry));
+    }
+
+    _entries[identifier] = (OCDStringTableEntry){ .hash = hash, .offset = (uint32_t)[_bytes length], .length = (uint32_t)length };
+    [_bytes appendBytes:string length:length];
+    _slots[slot] = identifier + 1;
+    _count++;
+
+    if (_count * 2 > _slotMask + 1) {
+        [self growSlots];
+    }
+
+    return identifier;
+}
+
+- (OCDStringID)identifierForString:(NSString *)string {
+    const char *utf8 = [string UTF8String];
+    return [self identifierForUTF8String:utf8 length:strlen(utf8)];
+}
+
+- (NSString *)stringForIdentifier:(OCDStringID)identifier {
+    NSParameterAssert(identifier < _count);
+
+    const OCDStringTableEntry *entry = &_entries[identifier];
+    return [[NSString alloc] initWithBytes:(const uint8_t *)[_bytes bytes] + entry->offset length:entry->length encoding:NSUTF8StringEncoding];
+}
+
+/**
+ * Doubles the number of slots and reinserts every entry using its stored hash.
+ */
+- (void)growSlots {
+    free(_slots);
+    _slotMask = (_slotMask << 1) | 1;
+    _slots = calloc(_slotMask + 1, sizeof(uint32_t));
+
+    for (NSUInteger identifier = 0; identifier < _count; identifier++) {
+        NSUInteger slot = (NSUInteger)_entries[identifier].hash & _slotMask;
+        while (_slots[slot] != OCDStringTableEmptySlot) {
+            slot = (slot + 1) & _slotMask;
+        }
+
+        _slots[slot] = (uint32_t)identifier + 1;
+    }
+}
+
+@end
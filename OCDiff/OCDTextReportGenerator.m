@@ -4,58 +4,76 @@
 #define COLOR_GREEN "\x1b[32m"
 #define COLOR_RESET "\x1b[0m"
 
-@implementation OCDTextReportGenerator
+@implementation OCDTextReportGenerator {
+    BOOL _useColor;
+    BOOL _multipleModules;
+    BOOL _hasDifferences;
+}
 
 - (void)generateReportForDifferences:(OCDAPIDifferences *)differences title:(NSString *)title {
-    BOOL useColor = isatty(STDOUT_FILENO) && getenv("TERM") != NULL;
+    [self beginReportWithTitle:title multipleModules:(differences.modules.count > 1)];
+
+    for (OCDModule *module in differences.modules) {
+        [self reportModule:module];
+    }
+
+    [self endReport];
+}
+
+- (void)beginReportWithTitle:(NSString *)title multipleModules:(BOOL)multipleModules {
+    _useColor = isatty(STDOUT_FILENO) && getenv("TERM") != NULL;
+    _multipleModules = multipleModules;
+    _hasDifferences = NO;
 
     if (title != nil) {
         printf("%s\n", [title UTF8String]);
     }
+}
 
-    BOOL hasDifferences = NO;
+- (void)reportModule:(OCDModule *)module {
+    BOOL useColor = _useColor;
 
-    for (OCDModule *module in differences.modules) {
-        if (differences.modules.count > 1) {
-            if (module.differenceType != OCDifferenceTypeRemoval && module.differences.count < 1) {
-                continue;
-            }
+    if (_multipleModules) {
+        if (module.differenceType != OCDifferenceTypeRemoval && module.differences.count < 1) {
+            return;
+        }
 
-            hasDifferences = YES;
-            printf("\n%s", module.name.UTF8String);
+        _hasDifferences = YES;
+        printf("\n%s", module.name.UTF8String);
 
-            if (module.differenceType == OCDifferenceTypeAddition) {
-                if (useColor) {
-                    printf(COLOR_GREEN);
-                }
-                printf(" (Added)");
-            } else if (module.differenceType == OCDifferenceTypeRemoval) {
-                if (useColor) {
-                    printf(COLOR_RED);
-                }
-                printf(" (Removed)");
+        if (module.differenceType == OCDifferenceTypeAddition) {
+            if (useColor) {
+                printf(COLOR_GREEN);
             }
-
+            printf(" (Added)");
+        } else if (module.differenceType == OCDifferenceTypeRemoval) {
             if (useColor) {
-                printf(COLOR_RESET);
+                printf(COLOR_RED);
             }
+            printf(" (Removed)");
+        }
 
-            printf("\n");
+        if (useColor) {
+            printf(COLOR_RESET);
+        }
 
-            for (NSUInteger i = 0; i < module.name.length; i++) {
-                printf("=");
-            }
+        printf("\n");
 
-            printf("\n");
+        for (NSUInteger i = 0; i < module.name.length; i++) {
+            printf("=");
         }
 
-        if (module.differences.count > 0) {
-            hasDifferences = YES;
-            [self printDifferences:module.differences useColor:useColor];
-        }
+        printf("\n");
     }
 
-    if (hasDifferences == NO) {
+    if (module.differences.count > 0) {
+        _hasDifferences = YES;
+        [self printDifferences:module.differences useColor:useColor];
+    }
+}
+
+- (void)endReport {
+    if (_hasDifferences == NO) {
         printf("No differences\n");
     }
 }
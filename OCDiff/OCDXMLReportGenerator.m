@@ -1,49 +1,146 @@
 #import "OCDXMLReportGenerator.h"
+#import "OCDBufferedWriter.h"
 
-@implementation OCDXMLReportGenerator
+@implementation OCDXMLReportGenerator {
+    OCDBufferedWriter *_writer;
+    NSString *_rootElementString;
+    BOOL _hasDifferences;
+}
 
 - (void)generateReportForDifferences:(OCDAPIDifferences *)differences title:(NSString *)title {
+    [self beginReportWithTitle:title multipleModules:(differences.modules.count > 1)];
+
+    for (OCDModule *module in differences.modules) {
+        [self reportModule:module];
+    }
+
+    [self endReport];
+}
+
+- (void)beginReportWithTitle:(NSString *)title multipleModules:(BOOL)multipleModules {
     NSXMLElement *rootElement = [NSXMLElement elementWithName:@"apidiff"];
     if (title != nil) {
         [rootElement addAttribute:[NSXMLNode attributeWithName:@"title" stringValue:title]];
     }
 
-    for (OCDModule *module in differences.modules) {
-        for (OCDifference *difference in module.differences) {
-            NSXMLElement *differenceElement = [NSXMLElement elementWithName:@"difference"];
-            [differenceElement addChild:[NSXMLElement elementWithName:@"type" stringValue:[self stringForDifferenceType:difference.type]]];
-            [differenceElement addChild:[NSXMLElement elementWithName:@"name" stringValue:difference.name]];
+    // The root element's start tag is written before the first difference, so that a report without differences
+    // is written as a single empty element as before
+    _rootElementString = [rootElement XMLString];
+    _hasDifferences = NO;
 
-            if ([module.name length] > 0) {
-                [differenceElement addChild:[NSXMLElement elementWithName:@"module" stringValue:module.name]];
-            }
+    // The writer is flushed after each step of the report so that its output stays in order with that of other
+    // reports written to standard output
+    _writer = [OCDBufferedWriter standardOutputWriter];
+    [_writer writeUTF8String:"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"];
+    [_writer flush:NULL];
+}
+
+- (void)reportModule:(OCDModule *)module {
+    OCDBufferedWriter *writer = _writer;
+
+    // Each difference is written as NSXMLNodePrettyPrint would serialize it at a depth of one, with each element
+    // that contains text on a single line and nested elements indented four spaces per level
+    for (OCDifference *difference in module.differences) {
+        if (_hasDifferences == NO) {
+            _hasDifferences = YES;
+            [writer writeString:[self startTagForElementString:_rootElementString]];
+            [writer writeUTF8String:"\n"];
+        }
 
-            [differenceElement addChild:[NSXMLElement elementWithName:@"path" stringValue:difference.path]];
-            [differenceElement addChild:[NSXMLElement elementWithName:@"lineNumber" stringValue:[NSString stringWithFormat:@"%tu", difference.lineNumber]]];
+        [writer writeUTF8String:"    <difference>\n"];
+        [self writeElement:"type" stringValue:[self stringForDifferenceType:difference.type] depth:2];
+        [self writeElement:"name" stringValue:difference.name depth:2];
 
-            if ([difference.modifications count] > 0) {
-                NSXMLElement *modificationsElement = [NSXMLElement elementWithName:@"modifications"];
+        if ([module.name length] > 0) {
+            [self writeElement:"module" stringValue:module.name depth:2];
+        }
 
-                for (OCDModification *modification in difference.modifications) {
-                    NSXMLElement *modificationElement = [NSXMLElement elementWithName:@"modification"];
-                    [modificationElement addChild:[NSXMLElement elementWithName:@"type" stringValue:[self stringForModificationType:modification.type]]];
-                    [modificationElement addChild:[NSXMLElement elementWithName:@"previousValue" stringValue:modification.previousValue]];
-                    [modificationElement addChild:[NSXMLElement elementWithName:@"currentValue" stringValue:modification.currentValue]];
+        [self writeElement:"path" stringValue:difference.path depth:2];
+        [self writeElement:"lineNumber" stringValue:[NSString stringWithFormat:@"%tu", difference.lineNumber] depth:2];
 
-                    [modificationsElement addChild:modificationElement];
-                }
+        if ([difference.modifications count] > 0) {
+            [writer writeUTF8String:"        <modifications>\n"];
 
-                [differenceElement addChild:modificationsElement];
+            for (OCDModification *modification in difference.modifications) {
+                [writer writeUTF8String:"            <modification>\n"];
+                [self writeElement:"type" stringValue:[self stringForModificationType:modification.type] depth:4];
+                [self writeElement:"previousValue" stringValue:modification.previousValue depth:4];
+                [self writeElement:"currentValue" stringValue:modification.currentValue depth:4];
+                [writer writeUTF8String:"            </modification>\n"];
             }
 
-            [rootElement addChild:differenceElement];
+            [writer writeUTF8String:"        </modifications>\n"];
         }
+
+        [writer writeUTF8String:"    </difference>\n"];
     }
 
-    NSXMLDocument *document = [NSXMLDocument documentWithRootElement:rootElement];
-    [document setCharacterEncoding:@"UTF-8"];
+    [writer flush:NULL];
+}
+
+- (void)endReport {
+    if (_hasDifferences) {
+        [_writer writeUTF8String:"</apidiff>\n"];
+    } else {
+        [_writer writeString:_rootElementString];
+        [_writer writeUTF8String:"\n"];
+    }
+
+    [_writer close:NULL];
+    _writer = nil;
+}
+
+/**
+ * Writes an element containing only text on its own line, indented to the specified depth.
+ */
+- (void)writeElement:(const char *)name stringValue:(NSString *)stringValue depth:(NSUInteger)depth {
+    OCDBufferedWriter *writer = _writer;
+
+    for (NSUInteger i = 0; i < depth; i++) {
+        [writer writeUTF8String:"    "];
+    }
+
+    [writer writeUTF8String:"<"];
+    [writer writeUTF8String:name];
+    [writer writeUTF8String:">"];
+
+    if ([stringValue length] > 0) {
+        [self writeText:stringValue];
+    }
+
+    [writer writeUTF8String:"</"];
+    [writer writeUTF8String:name];
+    [writer writeUTF8String:">\n"];
+}
+
+/**
+ * Writes text content escaped as NSXMLNode would escape it.
+ *
+ * Text without markup characters or control characters other than tab and newline, which includes nearly every
+ * name, path, and declaration, is written as is. Any other text is escaped by NSXMLNode itself.
+ */
+- (void)writeText:(NSString *)text {
+    static NSCharacterSet *escapedCharacters;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSMutableCharacterSet *characters = [NSMutableCharacterSet characterSetWithCharactersInString:@"&<>\"'"];
+        [characters addCharactersInRange:NSMakeRange(0, 0x20)];
+        [characters removeCharactersInString:@"\t\n"];
+        escapedCharacters = [characters copy];
+    });
+
+    if ([text rangeOfCharacterFromSet:escapedCharacters].location == NSNotFound) {
+        [_writer writeString:text];
+    } else {
+        [_writer writeString:[[NSXMLNode textWithStringValue:text] XMLString]];
+    }
+}
 
-    printf("%s\n", [[document XMLStringWithOptions:NSXMLNodePrettyPrint] UTF8String]);
+/**
+ * Returns the start tag of an element serialized without children.
+ */
+- (NSString *)startTagForElementString:(NSString *)elementString {
+    return [elementString substringToIndex:[elementString rangeOfString:@"></" options:NSBackwardsSearch].location + 1];
 }
 
 - (NSString *)stringForDifferenceType:(OCDifferenceType)type {
@@ -7,13 +7,21 @@ typedef NS_ENUM(NSUInteger, OCDifferenceType) {
     OCDifferenceTypeModification
 };
 
-@interface OCDifference : NSObject
+@interface OCDifference : NSObject <NSSecureCoding>
 
 + (instancetype)differenceWithType:(OCDifferenceType)type name:(NSString *)name path:(NSString *)path lineNumber:(NSUInteger)lineNumber;
 + (instancetype)differenceWithType:(OCDifferenceType)type name:(NSString *)name path:(NSString *)path lineNumber:(NSUInteger)lineNumber USR:(NSString *)USR;
 + (instancetype)modificationDifferenceWithName:(NSString *)name path:(NSString *)path lineNumber:(NSUInteger)lineNumber modifications:(NSArray<OCDModification *> *)modifications;
 + (instancetype)modificationDifferenceWithName:(NSString *)name path:(NSString *)path lineNumber:(NSUInteger)lineNumber USR:(NSString *)USR modifications:(NSArray<OCDModification *> *)modifications;
 
+/**
+ * Returns a difference whose name is produced by the specified block the first time it is read.
+ *
+ * A name is only needed when a difference is written to a report or ordered against another difference on the same
+ * line, so a comparator may defer formatting it until then. The block is released once it has been called.
+ */
++ (instancetype)differenceWithType:(OCDifferenceType)type nameBlock:(NSString *(^)(void))nameBlock path:(NSString *)path lineNumber:(NSUInteger)lineNumber USR:(NSString *)USR modifications:(NSArray<OCDModification *> *)modifications;
+
 @property (nonatomic, readonly) OCDifferenceType type;
 @property (nonatomic, readonly) NSString *name;
 @property (nonatomic, readonly) NSString *path;
@@ -25,4 +33,14 @@ typedef NS_ENUM(NSUInteger, OCDifferenceType) {
  */
 @property (nonatomic, readonly) NSArray<OCDModification *> *modifications;
 
+/**
+ * Sorts an array of differences into report order: by path, then type, then line number, then name. Paths are
+ * compared with localizedStandardCompare: and names case-insensitively. Differences that are equal in all of these
+ * keep their relative order.
+ *
+ * Each distinct path is ranked once, so that most differences are ordered by comparing integers rather than by
+ * localized string comparison.
+ */
++ (void)sortDifferences:(NSMutableArray<OCDifference *> *)differences;
+
 @end
@@ -1,6 +1,17 @@
 #import "OCDifference.h"
-
-@implementation OCDifference
+#import <stdatomic.h>
+
+@implementation OCDifference {
+    NSString *(^_nameBlock)(void);
+
+    /**
+     * Whether the name is produced by a block that has not yet been called, so that reads must be synchronized.
+     *
+     * This is cleared with release ordering once the name is stored, so a read that observes it cleared also observes
+     * the name and needs no lock.
+     */
+    atomic_bool _nameBlockPending;
+}
 
 - (instancetype)initWithType:(OCDifferenceType)type name:(NSString *)name path:(NSString *)path lineNumber:(NSUInteger)lineNumber USR:(NSString *)USR modifications:(NSArray *)modifications {
     if (!(self = [super init]))
@@ -32,6 +43,117 @@
     return [[self alloc] initWithType:OCDifferenceTypeModification name:name path:path lineNumber:lineNumber USR:USR modifications:modifications];
 }
 
++ (instancetype)differenceWithType:(OCDifferenceType)type nameBlock:(NSString *(^)(void))nameBlock path:(NSString *)path lineNumber:(NSUInteger)lineNumber USR:(NSString *)USR modifications:(NSArray *)modifications {
+    OCDifference *difference = [[self alloc] initWithType:type name:nil path:path lineNumber:lineNumber USR:USR modifications:modifications];
+    difference->_nameBlock = [nameBlock copy];
+    atomic_store_explicit(&difference->_nameBlockPending, true, memory_order_relaxed);
+    return difference;
+}
+
+- (NSString *)name {
+    if (!atomic_load_explicit(&_nameBlockPending, memory_order_acquire))
+        return _name;
+
+    // Differences may be sorted concurrently, so the first read must be synchronized
+    @synchronized (self) {
+        if (_nameBlock != nil) {
+            _name = [_nameBlock() copy];
+            _nameBlock = nil;
+            atomic_store_explicit(&_nameBlockPending, false, memory_order_release);
+        }
+
+        return _name;
+    }
+}
+
++ (BOOL)supportsSecureCoding {
+    return YES;
+}
+
+- (instancetype)initWithCoder:(NSCoder *)coder {
+    NSSet *modificationClasses = [NSSet setWithObjects:[NSArray class], [OCDModification class], nil];
+    return [self initWithType:(OCDifferenceType)[coder decodeIntegerForKey:@"type"]
+                         name:[coder decodeObjectOfClass:[NSString class] forKey:@"name"]
+                         path:[coder decodeObjectOfClass:[NSString class] forKey:@"path"]
+                   lineNumber:(NSUInteger)[coder decodeIntegerForKey:@"lineNumber"]
+                          USR:[coder decodeObjectOfClass:[NSString class] forKey:@"USR"]
+                modifications:[coder decodeObjectOfClasses:modificationClasses forKey:@"modifications"]];
+}
+
+- (void)encodeWithCoder:(NSCoder *)coder {
+    [coder encodeInteger:_type forKey:@"type"];
+    [coder encodeObject:self.name forKey:@"name"];
+    [coder encodeObject:_path forKey:@"path"];
+    [coder encodeInteger:_lineNumber forKey:@"lineNumber"];
+    [coder encodeObject:_USR forKey:@"USR"];
+    [coder encodeObject:_modifications forKey:@"modifications"];
+}
+
++ (void)sortDifferences:(NSMutableArray<OCDifference *> *)differences {
+    NSUInteger count = [differences count];
+    if (count < 2)
+        return;
+
+    // Paths are compared with localizedStandardCompare:, which is costly, but a report has far fewer distinct paths
+    // than differences. Ranking the paths once reduces the comparison of most differences to a single integer
+    // comparison of the path rank, type, and line number, leaving names to be compared only within a line.
+    NSMutableSet<NSString *> *pathSet = [NSMutableSet set];
+    for (OCDifference *difference in differences) {
+        [pathSet addObject:difference.path ?: @""];
+    }
+
+    // Distinct paths that compare as equal, such as those differing only in case, share a rank so that their
+    // differences are ordered by type and line number.
+    NSArray<NSString *> *paths = [[pathSet allObjects] sortedArrayUsingSelector:@selector(localizedStandardCompare:)];
+    NSMutableDictionary<NSString *, NSNumber *> *pathRanks = [NSMutableDictionary dictionaryWithCapacity:[paths count]];
+    NSUInteger rank = 0;
+    for (NSUInteger i = 0; i < [paths count]; i++) {
+        if (i > 0 && [paths[i - 1] localizedStandardCompare:paths[i]] != NSOrderedSame) {
+            rank = i;
+        }
+        pathRanks[paths[i]] = @(rank);
+    }
+
+    typedef struct {
+        uint64_t key;
+        NSUInteger index;
+    } OCDDifferenceSortEntry;
+
+    OCDDifferenceSortEntry *entries = malloc(count * sizeof(OCDDifferenceSortEntry));
+    for (NSUInteger i = 0; i < count; i++) {
+        OCDifference *difference = differences[i];
+        uint64_t rank = [pathRanks[difference.path ?: @""] unsignedLongLongValue];
+        uint64_t lineNumber = MIN(difference.lineNumber, (NSUInteger)UINT32_MAX);
+        entries[i] = (OCDDifferenceSortEntry){ .key = (rank << 34) | ((uint64_t)difference.type << 32) | lineNumber, .index = i };
+    }
+
+    NSArray<OCDifference *> *unsorted = [differences copy];
+    psort_b(entries, count, sizeof(OCDDifferenceSortEntry), ^int(const void *a, const void *b) {
+        const OCDDifferenceSortEntry *entry1 = a;
+        const OCDDifferenceSortEntry *entry2 = b;
+        if (entry1->key != entry2->key)
+            return entry1->key < entry2->key ? -1 : 1;
+
+        OCDifference *difference1 = unsorted[entry1->index];
+        OCDifference *difference2 = unsorted[entry2->index];
+        if (difference1.lineNumber != difference2.lineNumber)
+            return difference1.lineNumber < difference2.lineNumber ? -1 : 1;
+
+        NSComparisonResult result = [difference1.name caseInsensitiveCompare:difference2.name];
+        if (result != NSOrderedSame)
+            return (int)result;
+
+        // psort_b is not stable, so equal differences keep their original order as with a stable sort
+        return entry1->index < entry2->index ? -1 : (entry1->index > entry2->index ? 1 : 0);
+    });
+
+    for (NSUInteger i = 0; i < count; i++) {
+        differences[i] = unsorted[entries[i].index];
+    }
+
+    free(entries);
+}
+
 - (NSString *)description {
     NSMutableString *result = [NSMutableString stringWithString:@"["];
     switch (self.type) {
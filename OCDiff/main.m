@@ -6,6 +6,14 @@
 #import "NSString+OCDPathUtilities.h"
 #import "OCDAPIComparator.h"
 #import "OCDAPIDifferences.h"
+#import "OCDAPISnapshot.h"
+#import "OCDAPISnapshotComparator.h"
+#import "OCDCache.h"
+#import "OCDCursor.h"
+#import "OCDHash.h"
+#import "OCDParseCache.h"
+#import "OCDPrecompiledHeader.h"
+#import "OCDSDKManifest.h"
 #import "OCDSDK.h"
 #import "OCDHTMLReportGenerator.h"
 #import "OCDTextReportGenerator.h"
@@ -42,6 +50,20 @@ static void PrintUsage(void) {
     "  --args <args>      Compiler arguments for both API versions\n"
     "  --oldargs <args>   Compiler arguments for the old API version\n"
     "  --newargs <args>   Compiler arguments for the new API version\n"
+    "  --jobs <count>     Number of frameworks to compare concurrently when\n"
+    "                     comparing SDKs\n"
+    "  --save-snapshot <file>\n"
+    "                     Save a snapshot of the new API to the specified file\n"
+    "  --old-snapshot <file>\n"
+    "                     Use a saved API snapshot as the old API\n"
+    "  --new-snapshot <file>\n"
+    "                     Use a saved API snapshot as the new API\n"
+    "  --modules          Parse SDK frameworks as Clang modules, caching\n"
+    "                     imported modules across frameworks and runs\n"
+    "  --cache-dir <dir>  Directory for cached data that persists across runs\n"
+    "                     (default ~/Library/Caches/objc-diff)\n"
+    "  --no-cache         Do not read or write cached results\n"
+    "  --stats            Print performance statistics to standard error\n"
     "  --version          Show the version and exit\n",
     [name UTF8String]);
 }
@@ -123,6 +145,18 @@ static PLClangTranslationUnit *TranslationUnitForSource(PLClangSourceIndex *inde
     return translationUnit;
 }
 
+/**
+ * Returns the source of a virtual umbrella header importing the specified header paths.
+ */
+static NSString *UmbrellaSourceForHeaderPaths(NSArray *paths) {
+    NSMutableString *source = [[NSMutableString alloc] init];
+    for (NSString *path in paths) {
+        [source appendFormat:@"#import \"%@\"\n", path];
+    }
+
+    return source;
+}
+
 /**
  * Returns a translation unit for the specified header paths.
  *
@@ -131,22 +165,25 @@ static PLClangTranslationUnit *TranslationUnitForSource(PLClangSourceIndex *inde
  * include many declarations are only iterated over once per API, instead of once per header.
  */
 static PLClangTranslationUnit *TranslationUnitForHeaderPaths(PLClangSourceIndex *index, NSString *baseDirectory, NSArray *paths, NSArray *compilerArguments, BOOL printErrors) {
-    NSMutableString *source = [[NSMutableString alloc] init];
-    for (NSString *path in paths) {
-        [source appendFormat:@"#import \"%@\"\n", path];
-    }
-
-    return TranslationUnitForSource(index, baseDirectory, source, compilerArguments, printErrors);
+    return TranslationUnitForSource(index, baseDirectory, UmbrellaSourceForHeaderPaths(paths), compilerArguments, printErrors);
 }
 
-static PLClangTranslationUnit *TranslationUnitForPath(PLClangSourceIndex *index, NSString *path, NSArray *compilerArguments, BOOL printErrors) {
+/**
+ * Resolves the API at the specified path to the headers it is made up of.
+ *
+ * @param baseDirectory On return, the directory the header paths are relative to.
+ * @param headerPaths On return, the paths of the API's headers.
+ * @param resolvedCompilerArguments On return, the compiler arguments required to parse the headers.
+ * @return NO if the path does not exist.
+ */
+static BOOL ResolveHeadersForPath(NSString *path, NSArray *compilerArguments, NSString **baseDirectory, NSArray **headerPaths, NSArray **resolvedCompilerArguments) {
     BOOL isDirectory = NO;
 
     path = [path ocd_absolutePath];
 
     if ([[NSFileManager defaultManager] fileExistsAtPath:path isDirectory:&isDirectory] == NO) {
         fprintf(stderr, "%s not found\n", [path UTF8String]);
-        return nil;
+        return NO;
     }
 
     if (isDirectory) {
@@ -156,7 +193,7 @@ static PLClangTranslationUnit *TranslationUnitForPath(PLClangSourceIndex *index,
         if ([path ocd_isFrameworkPath]) {
             compilerArguments = [compilerArguments arrayByAddingObject:[@"-F" stringByAppendingString:[path stringByDeletingLastPathComponent]]];
             path = [path stringByAppendingPathComponent:@"Headers"];
-            return TranslationUnitForPath(index, path, compilerArguments, printErrors);
+            return ResolveHeadersForPath(path, compilerArguments, baseDirectory, headerPaths, resolvedCompilerArguments);
         }
 
         NSMutableArray *paths = [NSMutableArray array];
@@ -167,23 +204,120 @@ static PLClangTranslationUnit *TranslationUnitForPath(PLClangSourceIndex *index,
             }
         }
 
-        return TranslationUnitForHeaderPaths(index, path, paths, compilerArguments, printErrors);
+        *baseDirectory = path;
+        *headerPaths = paths;
     } else {
         NSString *containingFrameworkPath = ContainingFrameworkForPath(path);
         if (containingFrameworkPath != nil) {
             compilerArguments = [compilerArguments arrayByAddingObject:[@"-F" stringByAppendingString:[containingFrameworkPath stringByDeletingLastPathComponent]]];
         }
 
-        return TranslationUnitForHeaderPaths(index, [path stringByDeletingLastPathComponent], @[[path lastPathComponent]], compilerArguments, printErrors);
+        *baseDirectory = [path stringByDeletingLastPathComponent];
+        *headerPaths = @[[path lastPathComponent]];
+    }
+
+    *resolvedCompilerArguments = compilerArguments;
+    return YES;
+}
+
+static PLClangTranslationUnit *TranslationUnitForPath(PLClangSourceIndex *index, NSString *path, NSArray *compilerArguments, BOOL printErrors) {
+    NSString *baseDirectory;
+    NSArray *headerPaths;
+    if (ResolveHeadersForPath(path, compilerArguments, &baseDirectory, &headerPaths, &compilerArguments) == NO) {
+        return nil;
+    }
+
+    return TranslationUnitForHeaderPaths(index, baseDirectory, headerPaths, compilerArguments, printErrors);
+}
+
+/**
+ * Returns a translation unit for the specified framework source, retrying through the framework's umbrella header
+ * if the source cannot be parsed.
+ */
+static PLClangTranslationUnit *TranslationUnitForSDKFrameworkSource(PLClangSourceIndex *index, NSString *path, NSString *source, NSString *umbrellaSource, NSArray *compilerArguments, BOOL printErrors) {
+    PLClangTranslationUnit *translationUnit = TranslationUnitForSource(index, path, source, compilerArguments, printErrors && umbrellaSource == nil);
+    if (translationUnit == nil && umbrellaSource != nil) {
+        // Some SDK frameworks can only be parsed through their umbrella header.
+        // If parsing all headers fails, retry through the umbrella header. With --modules, frameworks with a module
+        // map are first parsed through it, and this is only reached if that fails or there is no module map.
+        translationUnit = TranslationUnitForSource(index, path, umbrellaSource, compilerArguments, printErrors);
+    }
+
+    return translationUnit;
+}
+
+/**
+ * Returns the first match of the specified pattern's capture group in a module map, or nil if there is none.
+ */
+static NSString *FirstMatchInModuleMap(NSString *moduleMap, NSString *pattern) {
+    if (moduleMap == nil) {
+        return nil;
+    }
+
+    NSRegularExpression *expression = [NSRegularExpression regularExpressionWithPattern:pattern options:NSRegularExpressionAnchorsMatchLines error:NULL];
+    NSTextCheckingResult *result = [expression firstMatchInString:moduleMap options:0 range:NSMakeRange(0, [moduleMap length])];
+
+    return result ? [moduleMap substringWithRange:[result rangeAtIndex:1]] : nil;
+}
+
+/**
+ * Returns the contents of the module map of the framework or /usr/include module at the specified path, or nil if it
+ * does not have one.
+ */
+static NSString *ModuleMapForFramework(NSString *frameworkPath) {
+    NSString *moduleMapPath;
+    if ([frameworkPath ocd_isFrameworkPath]) {
+        moduleMapPath = [frameworkPath stringByAppendingPathComponent:@"Modules/module.modulemap"];
+    } else {
+        moduleMapPath = [frameworkPath stringByAppendingPathComponent:@"module.modulemap"];
+    }
+
+    return [NSString stringWithContentsOfFile:moduleMapPath usedEncoding:NULL error:NULL];
+}
+
+/**
+ * Returns the specified compiler arguments without the arguments that enable modules.
+ */
+static NSArray *CompilerArgumentsWithoutModules(NSArray *compilerArguments) {
+    NSMutableArray *arguments = [NSMutableArray arrayWithCapacity:[compilerArguments count]];
+    for (NSString *argument in compilerArguments) {
+        if ([argument isEqualToString:@"-fmodules"] == NO && [argument hasPrefix:@"-fmodules-cache-path="] == NO) {
+            [arguments addObject:argument];
+        }
     }
+
+    return arguments;
 }
 
-static PLClangTranslationUnit *TranslationUnitForSDKFramework(PLClangSourceIndex *index, NSString *path, NSArray *compilerArguments) {
+/**
+ * Returns a translation unit for the specified SDK framework.
+ *
+ * When the compiler arguments enable modules, the framework is parsed as the module named by its module map: its own
+ * headers are parsed textually, while its dependencies are imported as modules and deserialized from the module
+ * cache. Declarations from imported modules are excluded from enumeration in the same way as those from a precompiled
+ * header. A framework whose module map cannot be read, or which cannot be parsed as a module, is parsed textually
+ * without modules.
+ *
+ * Otherwise, if a preamble is specified the framework is first parsed with the preamble included, or with the nearest
+ * ancestor of the preamble that does not contain the framework's own headers. The preamble's declarations are
+ * excluded from enumeration by the index, so this avoids both parsing and visiting the framework's dependencies. If
+ * the framework cannot be parsed with the preamble it is parsed on its own.
+ */
+static PLClangTranslationUnit *TranslationUnitForSDKFramework(PLClangSourceIndex *index, NSString *path, NSArray *compilerArguments, OCDPrecompiledHeader *preamble) {
     NSFileManager *fileManager = [NSFileManager defaultManager];
     NSString *frameworkName = [[path lastPathComponent] stringByDeletingPathExtension];
 
     path = [path ocd_absolutePath];
 
+    BOOL usesModules = [compilerArguments containsObject:@"-fmodules"];
+    NSString *moduleName = nil;
+    NSString *moduleUmbrellaHeader = nil;
+    if (usesModules) {
+        NSString *moduleMap = ModuleMapForFramework(path);
+        moduleName = FirstMatchInModuleMap(moduleMap, @"^\\s*(?:explicit\\s+)?(?:framework\\s+)?module\\s+([A-Za-z0-9_]+)");
+        moduleUmbrellaHeader = FirstMatchInModuleMap(moduleMap, @"umbrella\\s+header\\s+\"([^\"]+)\"");
+    }
+
     if ([path ocd_isFrameworkPath]) {
         path = [path stringByAppendingPathComponent:@"Headers"];
     }
@@ -215,20 +349,674 @@ static PLClangTranslationUnit *TranslationUnitForSDKFramework(PLClangSourceIndex
         }
     }
 
-    PLClangTranslationUnit *translationUnit = TranslationUnitForSource(index, path, source, compilerArguments, !umbrellaHeaderExists);
-    if (translationUnit == nil && umbrellaHeaderExists) {
-        // Some SDK frameworks can only be parsed through their umbrella header.
-        // If parsing all headers fails, retry through the umbrella header.
-        // TODO: Look into using module definition to avoid this issue.
-        NSString *umbrellaSource = [NSString stringWithFormat:@"#import <%@/%@.h>\n", frameworkName, frameworkName];
-        translationUnit = TranslationUnitForSource(index, path, umbrellaSource, compilerArguments, YES);
+    NSString *umbrellaSource = umbrellaHeaderExists ? [NSString stringWithFormat:@"#import <%@/%@.h>\n", frameworkName, frameworkName] : nil;
+    PLClangTranslationUnit *translationUnit = nil;
+
+    if (moduleName != nil) {
+        // Naming the module being built makes Clang parse its headers textually however they are imported, so
+        // frameworks whose module maps list headers individually or name an umbrella directory are imported
+        // through all of their headers. The module map defines the order the headers may be included in, so a
+        // single parse usually suffices.
+        NSArray *moduleCompilerArguments = [compilerArguments arrayByAddingObject:[@"-fmodule-name=" stringByAppendingString:moduleName]];
+        NSString *moduleSource = moduleUmbrellaHeader ? [NSString stringWithFormat:@"#import <%@/%@>\n", frameworkName, moduleUmbrellaHeader] : source;
+        translationUnit = TranslationUnitForSource(index, path, moduleSource, moduleCompilerArguments, NO);
+        if (translationUnit != nil) {
+            return translationUnit;
+        }
+    }
+
+    if (usesModules) {
+        // Without a module name the framework's own headers would be imported as a module and excluded from
+        // enumeration, so it is parsed textually
+        compilerArguments = CompilerArgumentsWithoutModules(compilerArguments);
+    }
+
+    while (preamble != nil && [preamble containsHeadersInDirectory:path]) {
+        preamble = preamble.parent;
+    }
+
+    if (preamble != nil) {
+        NSArray *preambleCompilerArguments = [preamble compilerArgumentsByAddingToArguments:compilerArguments];
+        translationUnit = TranslationUnitForSDKFrameworkSource(index, path, source, umbrellaSource, preambleCompilerArguments, NO);
+        if (translationUnit != nil) {
+            [preamble recordUse];
+        }
+    }
+
+    if (translationUnit == nil) {
+        translationUnit = TranslationUnitForSDKFrameworkSource(index, path, source, umbrellaSource, compilerArguments, YES);
     }
 
     return translationUnit;
 }
 
-static OCDAPIDifferences *DiffSDKs(NSString *oldSDKPath, NSArray *oldCompilerArguments, NSString *newSDKPath, NSArray *newCompilerArguments) {
-    NSMutableArray *modules = [NSMutableArray array];
+/**
+ * Returns an API source for the specified path.
+ *
+ * If the API is not part of an SDK and a cached SDK preamble key is specified, the API is first parsed with the
+ * cached precompiled SDK headers included. If that fails the API is parsed on its own, and if that succeeds, for
+ * example because the SDK was modified after the preamble was built, the cache entry is discarded.
+ */
+static OCDAPISource *APISourceForPath(PLClangSourceIndex *index, NSString *path, OCDSDK *sdk, NSArray *compilerArguments, OCDCache *cache, NSString *preambleKey) {
+    if (sdk != nil) {
+        PLClangTranslationUnit *translationUnit = TranslationUnitForSDKFramework(index, path, compilerArguments, nil);
+        return translationUnit ? [OCDAPISource APISourceWithTranslationUnit:translationUnit containingPath:path includeSystemHeaders:YES] : nil;
+    } else {
+        PLClangTranslationUnit *translationUnit = nil;
+
+        NSString *preamblePath = preambleKey ? [cache pathForKey:preambleKey extension:@"pch"] : nil;
+        if (preamblePath != nil) {
+            NSArray *preambleCompilerArguments = [compilerArguments arrayByAddingObjectsFromArray:@[@"-include-pch", preamblePath]];
+            translationUnit = TranslationUnitForPath(index, path, preambleCompilerArguments, NO);
+        }
+
+        if (translationUnit == nil) {
+            translationUnit = TranslationUnitForPath(index, path, compilerArguments, YES);
+
+            // The preamble is only at fault if the API parses without it; an API whose own headers fail to parse
+            // must not discard a valid preamble
+            if (translationUnit != nil && preamblePath != nil) {
+                [cache removeEntryForKey:preambleKey extension:@"pch"];
+            }
+        }
+
+        return translationUnit ? [OCDAPISource APISourceWithTranslationUnit:translationUnit] : nil;
+    }
+}
+
+/**
+ * Returns the absolute paths of every regular file within the specified directories, which do not need to exist.
+ */
+static NSArray<NSString *> *FilePathsInDirectories(NSArray<NSString *> *directories) {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSMutableSet<NSString *> *paths = [NSMutableSet set];
+
+    for (NSString *directory in directories) {
+        NSDirectoryEnumerator *enumerator = [fileManager enumeratorAtPath:directory];
+        for (NSString *file in enumerator) {
+            if ([enumerator.fileAttributes[NSFileType] isEqual:NSFileTypeRegular]) {
+                [paths addObject:[directory stringByAppendingPathComponent:file]];
+            }
+        }
+    }
+
+    return [paths allObjects];
+}
+
+/**
+ * Returns the parse cache key for the API at the specified path, which must not be part of an SDK, or nil if its
+ * headers could not be read.
+ *
+ * Headers may include any other file within the API's directory, or within the framework containing it, through the
+ * quote and framework search paths added for the API. Every such file is part of the key, not only the headers the
+ * umbrella source imports.
+ */
+static NSString *ParseCacheKeyForPath(NSString *path, OCDSDK *sdk, NSArray *compilerArguments) {
+    NSString *baseDirectory;
+    NSArray *headerPaths;
+    if (ResolveHeadersForPath(path, compilerArguments, &baseDirectory, &headerPaths, &compilerArguments) == NO) {
+        return nil;
+    }
+
+    NSMutableArray<NSString *> *directories = [NSMutableArray arrayWithObject:baseDirectory];
+    NSString *frameworkPath = ContainingFrameworkForPath(baseDirectory);
+    if (frameworkPath != nil) {
+        for (NSString *directory in @[@"Headers", @"PrivateHeaders", @"Modules"]) {
+            [directories addObject:[frameworkPath stringByAppendingPathComponent:directory]];
+        }
+    }
+
+    return [OCDParseCache keyForSource:UmbrellaSourceForHeaderPaths(headerPaths)
+                           headerPaths:FilePathsInDirectories(directories)
+                     compilerArguments:compilerArguments
+                                   SDK:sdk];
+}
+
+/**
+ * Returns a snapshot of a parsed API, storing it in the parse cache if a cache and key are specified.
+ */
+static OCDAPISnapshot *SnapshotForParsedAPI(OCDAPISource *source, NSDictionary *API, OCDParseCache *parseCache, NSString *parseCacheKey) {
+    OCDAPISnapshot *snapshot = [OCDAPIComparator snapshotForAPISource:source API:API];
+
+    NSError *error;
+    if (parseCache != nil && parseCacheKey != nil && [parseCache storeSnapshot:snapshot forKey:parseCacheKey error:&error] == NO) {
+        fprintf(stderr, "Could not cache API snapshot: %s\n", [[error localizedDescription] UTF8String]);
+    }
+
+    return snapshot;
+}
+
+/**
+ * Parses a framework within an SDK and returns a snapshot of its API, or nil if it could not be parsed.
+ *
+ * The translation unit is disposed of before returning, so that only the snapshot remains in memory.
+ */
+static OCDAPISnapshot *SnapshotForSDKFramework(PLClangSourceIndex *index, NSString *path, NSArray *compilerArguments, OCDPrecompiledHeader *preamble) {
+    OCDAPISnapshot *snapshot;
+
+    @autoreleasepool {
+        PLClangTranslationUnit *translationUnit = TranslationUnitForSDKFramework(index, path, compilerArguments, preamble);
+        if (translationUnit == nil) {
+            return nil;
+        }
+
+        OCDAPISource *source = [OCDAPISource APISourceWithTranslationUnit:translationUnit containingPath:path includeSystemHeaders:YES];
+        snapshot = [OCDAPIComparator snapshotForAPISource:source];
+    }
+
+    return snapshot;
+}
+
+/**
+ * Compares a single framework from the new SDK against its counterpart in the old SDK, if any.
+ *
+ * Each version is parsed and extracted to a snapshot in turn, so at most one translation unit is alive at a time.
+ *
+ * Returns nil if either version of the framework could not be parsed.
+ */
+static OCDModule *ModuleForSDKFramework(PLClangSourceIndex *index, NSString *frameworkName, NSString *oldPath, NSArray *oldCompilerArguments, OCDPrecompiledHeader *oldPreamble, NSString *newPath, NSArray *newCompilerArguments, OCDPrecompiledHeader *newPreamble) {
+    NSString *moduleName = [frameworkName stringByDeletingPathExtension];
+    OCDAPISnapshot *oldSnapshot;
+
+    if (oldPath != nil) {
+        oldSnapshot = SnapshotForSDKFramework(index, oldPath, oldCompilerArguments, oldPreamble);
+        if (oldSnapshot == nil) {
+            return nil;
+        }
+    } else {
+        oldSnapshot = [[[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:nil targetPlatformName:nil] snapshot];
+    }
+
+    OCDAPISnapshot *newSnapshot = SnapshotForSDKFramework(index, newPath, newCompilerArguments, newPreamble);
+    if (newSnapshot == nil) {
+        return nil;
+    }
+
+    NSArray<OCDifference *> *differences = [OCDAPISnapshotComparator differencesBetweenOldSnapshot:oldSnapshot newSnapshot:newSnapshot];
+    OCDifferenceType differenceType = (oldPath != nil) ? OCDifferenceTypeModification : OCDifferenceTypeAddition;
+
+    return [OCDModule moduleWithName:moduleName differenceType:differenceType differences:differences];
+}
+
+/**
+ * Returns the name used to import headers from the specified framework or /usr/include module.
+ */
+static NSString *ImportNameForFramework(NSString *frameworkName, NSString *frameworkPath) {
+    return [frameworkName hasSuffix:@".framework"] ? [frameworkName stringByDeletingPathExtension] : [frameworkPath lastPathComponent];
+}
+
+/**
+ * Returns the frameworks in an SDK that each framework imports, keyed by framework name.
+ *
+ * Dependencies are determined by scanning each framework's headers for imports of the form <Framework/Header.h>.
+ */
+static NSDictionary<NSString *, NSSet<NSString *> *> *DependenciesForFrameworks(NSDictionary<NSString *, NSString *> *frameworks) {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSRegularExpression *importExpression = [NSRegularExpression regularExpressionWithPattern:@"^[ \\t]*#[ \\t]*(?:import|include)[ \\t]*<([A-Za-z0-9_]+)/"
+                                                                                      options:NSRegularExpressionAnchorsMatchLines
+                                                                                        error:NULL];
+
+    NSMutableDictionary<NSString *, NSString *> *frameworksByImportName = [NSMutableDictionary dictionary];
+    for (NSString *frameworkName in frameworks) {
+        frameworksByImportName[ImportNameForFramework(frameworkName, frameworks[frameworkName])] = frameworkName;
+    }
+
+    NSMutableDictionary<NSString *, NSSet<NSString *> *> *dependencies = [NSMutableDictionary dictionary];
+    for (NSString *frameworkName in frameworks) {
+        @autoreleasepool {
+            NSString *headersPath = frameworks[frameworkName];
+            if ([headersPath ocd_isFrameworkPath]) {
+                headersPath = [headersPath stringByAppendingPathComponent:@"Headers"];
+            }
+
+            NSMutableSet<NSString *> *frameworkDependencies = [NSMutableSet set];
+            for (NSString *file in [fileManager enumeratorAtPath:headersPath]) {
+                if ([[file pathExtension] isEqual:@"h"] == NO) {
+                    continue;
+                }
+
+                NSString *contents = [NSString stringWithContentsOfFile:[headersPath stringByAppendingPathComponent:file] usedEncoding:NULL error:NULL];
+                if (contents == nil) {
+                    continue;
+                }
+
+                [importExpression enumerateMatchesInString:contents options:0 range:NSMakeRange(0, [contents length]) usingBlock:^(NSTextCheckingResult *result, NSMatchingFlags flags, BOOL *stop) {
+                    NSString *dependency = frameworksByImportName[[contents substringWithRange:[result rangeAtIndex:1]]];
+                    if (dependency != nil && [dependency isEqualToString:frameworkName] == NO) {
+                        [frameworkDependencies addObject:dependency];
+                    }
+                }];
+            }
+
+            dependencies[frameworkName] = frameworkDependencies;
+        }
+    }
+
+    return dependencies;
+}
+
+/**
+ * Visits a framework and its dependencies for DependencyComponentsForFrameworks, using Tarjan's algorithm.
+ */
+static void VisitDependencyComponent(NSString *frameworkName, NSDictionary<NSString *, NSSet<NSString *> *> *dependencies, NSMutableDictionary<NSString *, NSNumber *> *indexes, NSMutableDictionary<NSString *, NSNumber *> *lowLinks, NSMutableArray<NSString *> *stack, NSMutableSet<NSString *> *stackSet, NSMutableArray<NSArray<NSString *> *> *components) {
+    NSNumber *index = @([indexes count]);
+    indexes[frameworkName] = index;
+    lowLinks[frameworkName] = index;
+    [stack addObject:frameworkName];
+    [stackSet addObject:frameworkName];
+
+    for (NSString *dependency in [[dependencies[frameworkName] allObjects] sortedArrayUsingSelector:@selector(compare:)]) {
+        if (indexes[dependency] == nil) {
+            VisitDependencyComponent(dependency, dependencies, indexes, lowLinks, stack, stackSet, components);
+            lowLinks[frameworkName] = @(MIN([lowLinks[frameworkName] unsignedIntegerValue], [lowLinks[dependency] unsignedIntegerValue]));
+        } else if ([stackSet containsObject:dependency]) {
+            lowLinks[frameworkName] = @(MIN([lowLinks[frameworkName] unsignedIntegerValue], [indexes[dependency] unsignedIntegerValue]));
+        }
+    }
+
+    if ([lowLinks[frameworkName] isEqual:index]) {
+        NSMutableArray<NSString *> *component = [NSMutableArray array];
+        NSString *member;
+        do {
+            member = [stack lastObject];
+            [stack removeLastObject];
+            [stackSet removeObject:member];
+            [component addObject:member];
+        } while ([member isEqualToString:frameworkName] == NO);
+
+        [components addObject:[component sortedArrayUsingSelector:@selector(compare:)]];
+    }
+}
+
+/**
+ * Returns the strongly connected components of the framework dependency graph, each sorted by name, in dependency
+ * order: every component follows the components it imports. Frameworks within a component import each other
+ * directly or indirectly.
+ *
+ * Frameworks and their dependencies are visited in sorted order, so the same graph always produces the same result.
+ */
+static NSArray<NSArray<NSString *> *> *DependencyComponentsForFrameworks(NSArray<NSString *> *frameworkNames, NSDictionary<NSString *, NSSet<NSString *> *> *dependencies) {
+    NSMutableDictionary<NSString *, NSNumber *> *indexes = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSString *, NSNumber *> *lowLinks = [NSMutableDictionary dictionary];
+    NSMutableArray<NSString *> *stack = [NSMutableArray array];
+    NSMutableSet<NSString *> *stackSet = [NSMutableSet set];
+    NSMutableArray<NSArray<NSString *> *> *components = [NSMutableArray array];
+
+    for (NSString *frameworkName in [frameworkNames sortedArrayUsingSelector:@selector(compare:)]) {
+        if (indexes[frameworkName] == nil) {
+            VisitDependencyComponent(frameworkName, dependencies, indexes, lowLinks, stack, stackSet, components);
+        }
+    }
+
+    return components;
+}
+
+/**
+ * Returns a hash of the paths and contents of every file making up the headers of the specified framework or
+ * /usr/include module, including the framework's module map.
+ */
+static uint64_t HeaderTreeHashForFramework(NSString *frameworkPath) {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSString *headersPath = frameworkPath;
+    NSMutableDictionary<NSString *, NSString *> *files = [NSMutableDictionary dictionary];
+
+    if ([frameworkPath ocd_isFrameworkPath]) {
+        headersPath = [frameworkPath stringByAppendingPathComponent:@"Headers"];
+
+        NSString *moduleMapPath = [frameworkPath stringByAppendingPathComponent:@"Modules/module.modulemap"];
+        if ([fileManager fileExistsAtPath:moduleMapPath]) {
+            files[@"Modules/module.modulemap"] = moduleMapPath;
+        }
+    }
+
+    // Headers may include files other than .h files, so every regular file in the tree is hashed
+    NSDirectoryEnumerator *enumerator = [fileManager enumeratorAtPath:headersPath];
+    for (NSString *file in enumerator) {
+        if ([enumerator.fileAttributes[NSFileType] isEqual:NSFileTypeRegular]) {
+            files[[@"Headers" stringByAppendingPathComponent:file]] = [headersPath stringByAppendingPathComponent:file];
+        }
+    }
+
+    NSArray<NSString *> *orderedFiles = [[files allKeys] sortedArrayUsingSelector:@selector(compare:)];
+    NSMutableData *fileHashes = [NSMutableData dataWithCapacity:[orderedFiles count] * 2 * sizeof(uint64_t)];
+    for (NSString *file in orderedFiles) {
+        @autoreleasepool {
+            const char *fileName = [file UTF8String];
+            NSData *contents = [NSData dataWithContentsOfFile:files[file] options:NSDataReadingMappedIfSafe error:NULL];
+            uint64_t hashes[2] = {
+                OCDHash64(fileName, strlen(fileName), 0),
+                contents ? OCDHash64([contents bytes], [contents length], 0) : 0
+            };
+            [fileHashes appendBytes:hashes length:sizeof(hashes)];
+        }
+    }
+
+    return OCDHash64([fileHashes bytes], [fileHashes length], 0);
+}
+
+/**
+ * Returns the header tree hash of each of the specified frameworks, keyed by framework name. Frameworks are hashed
+ * concurrently.
+ */
+static NSDictionary<NSString *, NSNumber *> *HeaderTreeHashesForFrameworks(NSDictionary<NSString *, NSString *> *frameworks) {
+    NSArray<NSString *> *frameworkNames = [frameworks allKeys];
+    NSUInteger frameworkCount = [frameworkNames count];
+    uint64_t *hashes = calloc(MAX(frameworkCount, 1), sizeof(uint64_t));
+
+    dispatch_apply(frameworkCount, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        @autoreleasepool {
+            hashes[i] = HeaderTreeHashForFramework(frameworks[frameworkNames[i]]);
+        }
+    });
+
+    NSMutableDictionary<NSString *, NSNumber *> *frameworkHashes = [NSMutableDictionary dictionaryWithCapacity:frameworkCount];
+    for (NSUInteger i = 0; i < frameworkCount; i++) {
+        frameworkHashes[frameworkNames[i]] = @(hashes[i]);
+    }
+
+    free(hashes);
+    return frameworkHashes;
+}
+
+/**
+ * Returns the specified framework and every framework it imports, directly or indirectly.
+ */
+static NSSet<NSString *> *FrameworkWithTransitiveDependencies(NSString *frameworkName, NSDictionary<NSString *, NSSet<NSString *> *> *dependencies) {
+    NSMutableSet<NSString *> *visited = [NSMutableSet setWithObject:frameworkName];
+    NSMutableArray<NSString *> *pending = [NSMutableArray arrayWithObject:frameworkName];
+
+    while ([pending count] > 0) {
+        NSString *name = [pending lastObject];
+        [pending removeLastObject];
+
+        for (NSString *dependency in dependencies[name]) {
+            if ([visited containsObject:dependency] == NO) {
+                [visited addObject:dependency];
+                [pending addObject:dependency];
+            }
+        }
+    }
+
+    return visited;
+}
+
+/**
+ * Returns the names of the frameworks present in both SDKs whose headers, and the headers of every framework they
+ * import directly or indirectly, are byte-identical in both SDKs.
+ *
+ * Parsing such a framework with the same compiler arguments in both SDKs would produce identical APIs, so it does
+ * not need to be parsed to know that it has no differences.
+ */
+static NSSet<NSString *> *UnchangedFrameworks(NSDictionary<NSString *, NSNumber *> *oldHashes, NSDictionary<NSString *, NSNumber *> *newHashes, NSDictionary<NSString *, NSSet<NSString *> *> *newDependencies) {
+    NSMutableSet<NSString *> *unchangedFrameworks = [NSMutableSet set];
+
+    for (NSString *frameworkName in newHashes) {
+        // Any changed or added framework the framework reaches may change how its headers parse
+        BOOL unchanged = YES;
+        for (NSString *name in FrameworkWithTransitiveDependencies(frameworkName, newDependencies)) {
+            if ([oldHashes[name] isEqual:newHashes[name]] == NO) {
+                unchanged = NO;
+                break;
+            }
+        }
+
+        if (unchanged) {
+            [unchangedFrameworks addObject:frameworkName];
+        }
+    }
+
+    return unchangedFrameworks;
+}
+
+/**
+ * Returns the inputs that the module for the specified framework is computed from, for recording in an SDK manifest.
+ *
+ * These are the hashes of the compiler arguments and of the header trees of the framework and every framework it
+ * imports, in both SDKs.
+ */
+static NSDictionary<NSString *, NSString *> *ManifestInputsForFramework(NSString *frameworkName, NSString *argumentsHash, NSDictionary<NSString *, NSNumber *> *oldHashes, NSDictionary<NSString *, NSSet<NSString *> *> *oldDependencies, NSDictionary<NSString *, NSNumber *> *newHashes, NSDictionary<NSString *, NSSet<NSString *> *> *newDependencies) {
+    NSMutableDictionary<NSString *, NSString *> *inputs = [NSMutableDictionary dictionary];
+    inputs[@"arguments"] = argumentsHash;
+
+    if (oldHashes[frameworkName] != nil) {
+        for (NSString *name in FrameworkWithTransitiveDependencies(frameworkName, oldDependencies)) {
+            inputs[[@"old:" stringByAppendingString:name]] = [NSString stringWithFormat:@"%016llx", [oldHashes[name] unsignedLongLongValue]];
+        }
+    }
+
+    for (NSString *name in FrameworkWithTransitiveDependencies(frameworkName, newDependencies)) {
+        inputs[[@"new:" stringByAppendingString:name]] = [NSString stringWithFormat:@"%016llx", [newHashes[name] unsignedLongLongValue]];
+    }
+
+    return inputs;
+}
+
+/**
+ * Returns the key of the manifest of comparisons against the specified old SDK.
+ *
+ * Module results depend on the version of objc-diff and Clang that computed them, so these are part of the key.
+ */
+static NSString *SDKManifestKey(NSString *oldSDKPath) {
+    NSString *version = [[NSBundle mainBundle] objectForInfoDictionaryKey:@"CFBundleVersion"] ?: @"";
+    return [OCDCache keyForComponents:@[@"sdk-manifest", version, PLClangGetVersionString(), [oldSDKPath stringByStandardizingPath]]];
+}
+
+/**
+ * Builds precompiled headers of the dependencies of the frameworks in an SDK.
+ *
+ * Each framework is parsed with a precompiled header of the umbrella headers of exactly the frameworks it imports,
+ * directly or indirectly, so it parses only its own headers on top of the precompiled state of its own dependencies
+ * and no other framework's declarations or macros are in scope. Frameworks that import each other form one
+ * component of the dependency graph and are parsed with the precompiled header of the component's dependencies.
+ *
+ * Frameworks with the same dependencies share a precompiled header, and each precompiled header is chained onto the
+ * largest one already built whose frameworks are a subset of its own, so most add only a few umbrella headers.
+ *
+ * Returns the precompiled header to parse each framework with, keyed by framework name. Frameworks without
+ * dependencies have none. On return, layers contains the precompiled headers built for each layer of the dependency
+ * graph, where a component's layer is one more than the highest layer of the components it imports.
+ */
+static NSDictionary<NSString *, OCDPrecompiledHeader *> *PrecompiledHeadersForSDK(NSString *sdkPath, NSDictionary<NSString *, NSString *> *frameworks, NSDictionary<NSString *, NSSet<NSString *> *> *dependencies, NSArray *unsupportedFrameworks, NSArray *compilerArguments, NSArray<NSArray<OCDPrecompiledHeader *> *> **layers) {
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray<NSArray<NSString *> *> *components = DependencyComponentsForFrameworks([frameworks allKeys], dependencies);
+
+    // Frameworks whose umbrella headers can be precompiled, in dependency order
+    NSMutableDictionary<NSString *, NSNumber *> *componentIndexes = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSString *, NSNumber *> *precompiledOrder = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < [components count]; i++) {
+        for (NSString *frameworkName in components[i]) {
+            componentIndexes[frameworkName] = @(i);
+
+            NSString *importName = ImportNameForFramework(frameworkName, frameworks[frameworkName]);
+            NSString *umbrellaPath = [frameworks[frameworkName] stringByAppendingFormat:@"/Headers/%@.h", importName];
+            if ([unsupportedFrameworks containsObject:frameworkName] == NO && [fileManager fileExistsAtPath:umbrellaPath]) {
+                precompiledOrder[frameworkName] = @([precompiledOrder count]);
+            }
+        }
+    }
+
+    NSMutableDictionary<NSString *, id> *precompiledHeadersByFrameworks = [NSMutableDictionary dictionary];
+    NSMutableArray<OCDPrecompiledHeader *> *builtPrecompiledHeaders = [NSMutableArray array];
+    NSMapTable<OCDPrecompiledHeader *, NSSet<NSString *> *> *precompiledFrameworks = [NSMapTable strongToStrongObjectsMapTable];
+    NSMutableArray<NSMutableArray<OCDPrecompiledHeader *> *> *builtLayers = [NSMutableArray array];
+
+    // Returns a precompiled header of the umbrella headers of the specified frameworks, or the largest available
+    // subset of them if it could not be built
+    OCDPrecompiledHeader *(^precompiledHeaderForFrameworks)(NSSet<NSString *> *, NSUInteger) = ^OCDPrecompiledHeader *(NSSet<NSString *> *frameworkNames, NSUInteger layer) {
+        if ([frameworkNames count] == 0) {
+            return nil;
+        }
+
+        NSArray<NSString *> *orderedNames = [[frameworkNames allObjects] sortedArrayUsingComparator:^NSComparisonResult(NSString *obj1, NSString *obj2) {
+            return [precompiledOrder[obj1] compare:precompiledOrder[obj2]];
+        }];
+        NSString *key = [orderedNames componentsJoinedByString:@"\n"];
+        id existingPrecompiledHeader = precompiledHeadersByFrameworks[key];
+        if (existingPrecompiledHeader != nil) {
+            return existingPrecompiledHeader != [NSNull null] ? existingPrecompiledHeader : nil;
+        }
+
+        OCDPrecompiledHeader *parent = nil;
+        NSUInteger parentCount = 0;
+        for (OCDPrecompiledHeader *candidate in builtPrecompiledHeaders) {
+            NSSet<NSString *> *candidateFrameworks = [precompiledFrameworks objectForKey:candidate];
+            if ([candidateFrameworks count] > parentCount && [candidateFrameworks isSubsetOfSet:frameworkNames]) {
+                parent = candidate;
+                parentCount = [candidateFrameworks count];
+            }
+        }
+
+        NSMutableString *source = [NSMutableString string];
+        for (NSString *frameworkName in orderedNames) {
+            if ([[precompiledFrameworks objectForKey:parent] containsObject:frameworkName] == NO) {
+                NSString *importName = ImportNameForFramework(frameworkName, frameworks[frameworkName]);
+                [source appendFormat:@"#import <%@/%@.h>\n", importName, importName];
+            }
+        }
+
+        NSError *error;
+        OCDPrecompiledHeader *precompiledHeader = [OCDPrecompiledHeader precompiledHeaderWithSource:source compilerArguments:compilerArguments parent:parent error:&error];
+        if (precompiledHeader != nil) {
+            [builtPrecompiledHeaders addObject:precompiledHeader];
+            [precompiledFrameworks setObject:frameworkNames forKey:precompiledHeader];
+
+            while ([builtLayers count] <= layer) {
+                [builtLayers addObject:[NSMutableArray array]];
+            }
+            [builtLayers[layer] addObject:precompiledHeader];
+        } else {
+            // The subset still contains only dependencies, so it remains safe to parse with
+            fprintf(stderr, "Failed to precompile dependencies %s of %s: %s\n",
+                    [[orderedNames componentsJoinedByString:@", "] UTF8String], [sdkPath UTF8String], [[error localizedDescription] UTF8String]);
+            precompiledHeader = parent;
+        }
+
+        precompiledHeadersByFrameworks[key] = precompiledHeader ?: [NSNull null];
+        return precompiledHeader;
+    };
+
+    NSMutableDictionary<NSString *, OCDPrecompiledHeader *> *precompiledHeaders = [NSMutableDictionary dictionary];
+    NSMutableArray<NSSet<NSString *> *> *componentDependencies = [NSMutableArray arrayWithCapacity:[components count]];
+    NSMutableArray<NSNumber *> *componentLayers = [NSMutableArray arrayWithCapacity:[components count]];
+
+    for (NSUInteger i = 0; i < [components count]; i++) {
+        NSMutableSet<NSString *> *transitiveDependencies = [NSMutableSet set];
+        NSMutableIndexSet *dependencyComponents = [NSMutableIndexSet indexSet];
+        NSUInteger layer = 0;
+
+        for (NSString *frameworkName in components[i]) {
+            for (NSString *dependency in dependencies[frameworkName]) {
+                NSUInteger dependencyComponent = [componentIndexes[dependency] unsignedIntegerValue];
+                if (dependencyComponent != i) {
+                    [dependencyComponents addIndex:dependencyComponent];
+                }
+            }
+        }
+
+        // Components precede the components that import them, so their dependencies are already known. Building the
+        // precompiled header of each imported component's frameworks first lets this component's chain onto it.
+        [dependencyComponents enumerateIndexesUsingBlock:^(NSUInteger dependencyComponent, BOOL *stop) {
+            NSMutableSet<NSString *> *exportedFrameworks = [componentDependencies[dependencyComponent] mutableCopy];
+            [exportedFrameworks addObjectsFromArray:components[dependencyComponent]];
+            [transitiveDependencies unionSet:exportedFrameworks];
+
+            NSUInteger dependencyLayer = [componentLayers[dependencyComponent] unsignedIntegerValue];
+            [exportedFrameworks filterUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(NSString *frameworkName, NSDictionary *bindings) {
+                return precompiledOrder[frameworkName] != nil;
+            }]];
+            precompiledHeaderForFrameworks(exportedFrameworks, dependencyLayer);
+        }];
+
+        for (NSNumber *dependencyLayer in [componentLayers objectsAtIndexes:dependencyComponents]) {
+            layer = MAX(layer, [dependencyLayer unsignedIntegerValue] + 1);
+        }
+
+        [componentDependencies addObject:transitiveDependencies];
+        [componentLayers addObject:@(layer)];
+
+        NSMutableSet<NSString *> *precompiledDependencies = [NSMutableSet set];
+        for (NSString *frameworkName in transitiveDependencies) {
+            if (precompiledOrder[frameworkName] != nil) {
+                [precompiledDependencies addObject:frameworkName];
+            }
+        }
+
+        OCDPrecompiledHeader *precompiledHeader = precompiledHeaderForFrameworks(precompiledDependencies, layer);
+        if (precompiledHeader != nil) {
+            for (NSString *frameworkName in components[i]) {
+                precompiledHeaders[frameworkName] = precompiledHeader;
+            }
+        }
+    }
+
+    if (layers != NULL) {
+        *layers = builtLayers;
+    }
+
+    return precompiledHeaders;
+}
+
+/**
+ * Prints the preprocessing time saved by the precompiled headers built for each dependency layer to standard error.
+ *
+ * Every translation unit parsed with a precompiled header or any precompiled header chained onto it would otherwise
+ * have parsed that precompiled header's headers itself, so the time saved is estimated as its build time for each
+ * such translation unit, less the time spent building it once.
+ */
+static void PrintPrecompiledHeaderStatistics(NSString *sdkPath, NSArray<NSArray<OCDPrecompiledHeader *> *> *layers) {
+    fprintf(stderr, "Precompiled dependency layers for %s:\n", [sdkPath UTF8String]);
+
+    NSMapTable<OCDPrecompiledHeader *, NSNumber *> *chainedUseCounts = [NSMapTable strongToStrongObjectsMapTable];
+    for (NSArray<OCDPrecompiledHeader *> *layer in layers) {
+        for (OCDPrecompiledHeader *precompiledHeader in layer) {
+            NSUInteger useCount = precompiledHeader.useCount;
+            for (OCDPrecompiledHeader *ancestor = precompiledHeader; ancestor != nil; ancestor = ancestor.parent) {
+                NSUInteger chainedUseCount = [[chainedUseCounts objectForKey:ancestor] unsignedIntegerValue];
+                [chainedUseCounts setObject:@(chainedUseCount + useCount) forKey:ancestor];
+            }
+        }
+    }
+
+    for (NSUInteger i = 0; i < [layers count]; i++) {
+        if ([layers[i] count] == 0) {
+            continue;
+        }
+
+        NSUInteger headerCount = 0;
+        NSUInteger useCount = 0;
+        NSTimeInterval buildTime = 0;
+        NSTimeInterval savedTime = 0;
+        for (OCDPrecompiledHeader *precompiledHeader in layers[i]) {
+            headerCount += precompiledHeader.headerCount;
+            useCount += precompiledHeader.useCount;
+            buildTime += precompiledHeader.buildTime;
+            savedTime += precompiledHeader.buildTime * [[chainedUseCounts objectForKey:precompiledHeader] unsignedIntegerValue] - precompiledHeader.buildTime;
+        }
+
+        fprintf(stderr, "  Layer %lu: %lu precompiled headers, %lu headers, built in %.2fs, used by %lu translation units, saved %.2fs\n",
+                (unsigned long)i, (unsigned long)[layers[i] count], (unsigned long)headerCount, buildTime, (unsigned long)useCount, savedTime);
+    }
+}
+
+/**
+ * Prints the number of cursor property reads answered by OCDCursor without a libclang call to standard error.
+ */
+static void PrintCursorStatistics(void) {
+    fprintf(stderr, "Cursor property reads:\n");
+
+    for (OCDCursorProperty property = 0; property < OCDCursorPropertyCount; property++) {
+        fprintf(stderr, "  %s: %llu hits, %llu misses\n", [[OCDCursor nameForProperty:property] UTF8String],
+                [OCDCursor hitCountForProperty:property], [OCDCursor missCountForProperty:property]);
+    }
+}
+
+/**
+ * Compares the frameworks of two SDKs, passing each resulting module to the handler in order of module name as
+ * soon as it and all modules before it are available.
+ */
+static void DiffSDKs(OCDSDK *oldSDK, NSArray *oldCompilerArguments, OCDSDK *newSDK, NSArray *newCompilerArguments, NSUInteger jobs, OCDCache *cache, BOOL printStatistics, void (^moduleHandler)(OCDModule *)) {
+    NSString *oldSDKPath = oldSDK.path;
+    NSString *newSDKPath = newSDK.path;
     NSDictionary<NSString *, NSString *> *oldFrameworks = FrameworksForSDKAtPath(oldSDKPath);
     NSDictionary<NSString *, NSString *> *newFrameworks = FrameworksForSDKAtPath(newSDKPath);
 
@@ -239,70 +1027,268 @@ static OCDAPIDifferences *DiffSDKs(NSString *oldSDKPath, NSArray *oldCompilerArg
         @"Tk.framework" // Requires X11
     ];
 
-    PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:0];
+    // Frameworks are processed in the order their modules are reported, including those that were removed, so that
+    // the modules awaiting earlier ones in the reorder buffer below are few
+    NSMutableSet *allFrameworks = [NSMutableSet setWithArray:oldFrameworks.allKeys];
+    [allFrameworks addObjectsFromArray:newFrameworks.allKeys];
+    NSArray *orderedFrameworks = [allFrameworks.allObjects sortedArrayUsingComparator:^NSComparisonResult(NSString *obj1, NSString *obj2) {
+        return [[obj1 stringByDeletingPathExtension] localizedStandardCompare:[obj2 stringByDeletingPathExtension]];
+    }];
+    NSUInteger slotCount = [orderedFrameworks count];
+    NSUInteger frameworkCount = [newFrameworks count];
+
+    // Hash the header trees of both SDKs up front. When both SDKs are parsed with the same compiler arguments, a
+    // framework whose headers and dependencies are byte-identical is known to have no differences without parsing it.
+    NSDate *reuseStartDate = [NSDate date];
+    NSDictionary<NSString *, NSSet<NSString *> *> *oldDependencies = DependenciesForFrameworks(oldFrameworks);
+    NSDictionary<NSString *, NSSet<NSString *> *> *newDependencies = DependenciesForFrameworks(newFrameworks);
+    NSDictionary<NSString *, NSNumber *> *oldHashes = HeaderTreeHashesForFrameworks(oldFrameworks);
+    NSDictionary<NSString *, NSNumber *> *newHashes = HeaderTreeHashesForFrameworks(newFrameworks);
+    NSArray *oldSDKIndependentArguments = [oldSDK compilerArgumentsIndependentOfSDK:oldCompilerArguments];
+    NSArray *newSDKIndependentArguments = [newSDK compilerArgumentsIndependentOfSDK:newCompilerArguments];
+
+    // Every framework also depends on the SDK's system headers, such as Availability.h and TargetConditionals.h
+    uint64_t oldSystemHeadersHash = HeaderTreeHashForFramework([oldSDKPath stringByAppendingPathComponent:@"usr/include"]);
+    uint64_t newSystemHeadersHash = HeaderTreeHashForFramework([newSDKPath stringByAppendingPathComponent:@"usr/include"]);
+
+    NSSet<NSString *> *unchangedFrameworks = [NSSet set];
+    if ([oldSDKIndependentArguments isEqualToArray:newSDKIndependentArguments] && oldSystemHeadersHash == newSystemHeadersHash) {
+        unchangedFrameworks = UnchangedFrameworks(oldHashes, newHashes, newDependencies);
+    }
 
-    for (NSString *frameworkName in oldFrameworks) {
-        if (newFrameworks[frameworkName] == nil) {
-            [modules addObject:[OCDModule moduleWithName:[frameworkName stringByDeletingPathExtension]
-                                          differenceType:OCDifferenceTypeRemoval
-                                             differences:nil]];
+    // Modules computed by a previous comparison against the same old SDK are reused for frameworks whose inputs
+    // have not changed since. The manifest is rewritten with the results of this comparison.
+    NSString *manifestKey = SDKManifestKey(oldSDKPath);
+    OCDSDKManifest *previousManifest = nil;
+    NSString *previousManifestPath = [cache pathForKey:manifestKey extension:@"manifest"];
+    if (previousManifestPath != nil) {
+        NSData *data = [NSData dataWithContentsOfFile:previousManifestPath options:NSDataReadingMappedIfSafe error:NULL];
+        previousManifest = data ? [OCDSDKManifest manifestWithData:data error:NULL] : nil;
+    }
+
+    // Results are only recorded when there is a cache to write the manifest to
+    OCDSDKManifest *manifest = cache ? [[OCDSDKManifest alloc] init] : nil;
+    // The inputs shared by every framework are the compiler arguments and the system headers
+    NSMutableArray *argumentsHashComponents = [NSMutableArray arrayWithArray:oldSDKIndependentArguments];
+    [argumentsHashComponents addObject:@"--"];
+    [argumentsHashComponents addObjectsFromArray:newSDKIndependentArguments];
+    [argumentsHashComponents addObject:[NSString stringWithFormat:@"%016llx %016llx", oldSystemHeadersHash, newSystemHeadersHash]];
+    NSString *argumentsHash = [OCDCache keyForComponents:argumentsHashComponents];
+
+    NSMutableDictionary<NSString *, NSDictionary *> *frameworkInputs = [NSMutableDictionary dictionary];
+    NSMutableSet<NSString *> *reusedFrameworks = [NSMutableSet set];
+    BOOL parsingRequired = NO;
+
+    for (NSString *frameworkName in orderedFrameworks) {
+        if (newFrameworks[frameworkName] == nil || [unsupportedFrameworks containsObject:frameworkName]) {
+            continue;
+        }
+
+        NSDictionary *inputs = ManifestInputsForFramework(frameworkName, argumentsHash, oldHashes, oldDependencies, newHashes, newDependencies);
+        frameworkInputs[frameworkName] = inputs;
+
+        // Only the names of reusable frameworks are kept; each module is decoded when it is reported
+        if ([previousManifest hasModuleForFramework:frameworkName inputs:inputs]) {
+            [reusedFrameworks addObject:frameworkName];
+        } else if ([unchangedFrameworks containsObject:frameworkName] == NO) {
+            parsingRequired = YES;
         }
     }
 
-    NSSortDescriptor *nameSortDescriptor = [NSSortDescriptor sortDescriptorWithKey:@"self" ascending:YES selector:@selector(localizedStandardCompare:)];
-    NSArray *orderedNewFrameworks = [newFrameworks.allKeys sortedArrayUsingDescriptors:@[nameSortDescriptor]];
+    NSTimeInterval reuseTime = -[reuseStartDate timeIntervalSinceNow];
+    NSDate *recomputeStartDate = [NSDate date];
+
+    // Precompile each SDK's frameworks in dependency order and have the index exclude the precompiled declarations,
+    // rather than parsing and visiting a framework's dependencies again for every framework that imports them. When
+    // parsing with modules, dependencies are instead loaded from the module cache.
+    NSArray<NSArray<OCDPrecompiledHeader *> *> *oldLayers;
+    NSArray<NSArray<OCDPrecompiledHeader *> *> *newLayers;
+    NSDictionary<NSString *, OCDPrecompiledHeader *> *oldPreambles;
+    NSDictionary<NSString *, OCDPrecompiledHeader *> *newPreambles;
+    if (parsingRequired && [oldCompilerArguments containsObject:@"-fmodules"] == NO) {
+        oldPreambles = PrecompiledHeadersForSDK(oldSDKPath, oldFrameworks, oldDependencies, unsupportedFrameworks, oldCompilerArguments, &oldLayers);
+    }
 
-    for (NSString *frameworkName in orderedNewFrameworks) {
-        @autoreleasepool {
-            if ([unsupportedFrameworks containsObject:frameworkName]) {
-                printf("Skipping %s (unsupported)\n", frameworkName.UTF8String);
-                continue;
-            }
+    if (parsingRequired && [newCompilerArguments containsObject:@"-fmodules"] == NO) {
+        newPreambles = PrecompiledHeadersForSDK(newSDKPath, newFrameworks, newDependencies, unsupportedFrameworks, newCompilerArguments, &newLayers);
+    }
+
+    // Returns the module for a framework, or nil if the framework is unsupported or could not be parsed, reporting
+    // progress before any parsing begins
+    OCDModule *(^moduleForFramework)(PLClangSourceIndex *, NSString *, void (^)(NSString *)) = ^OCDModule *(PLClangSourceIndex *index, NSString *frameworkName, void (^reportProgress)(NSString *)) {
+        if (newFrameworks[frameworkName] == nil) {
+            return [OCDModule moduleWithName:[frameworkName stringByDeletingPathExtension]
+                              differenceType:OCDifferenceTypeRemoval
+                                 differences:nil];
+        }
 
-            printf("Comparing %s\n", frameworkName.UTF8String);
+        if ([unsupportedFrameworks containsObject:frameworkName]) {
+            reportProgress([NSString stringWithFormat:@"Skipping %@ (unsupported)\n", frameworkName]);
+            return nil;
+        }
 
-            NSString *oldPath = oldFrameworks[frameworkName];
-            NSString *newPath = newFrameworks[frameworkName];
+        OCDModule *module = nil;
+        if ([reusedFrameworks containsObject:frameworkName]) {
+            module = [previousManifest moduleForFramework:frameworkName inputs:frameworkInputs[frameworkName]];
+        }
 
-            if (oldPath != nil) {
-                PLClangTranslationUnit *oldTU = TranslationUnitForSDKFramework(index, oldPath, oldCompilerArguments);
-                if (oldTU == nil) {
-                    continue;
-                }
+        if (module != nil) {
+            reportProgress([NSString stringWithFormat:@"Skipping %@ (reused)\n", frameworkName]);
+        } else if ([unchangedFrameworks containsObject:frameworkName]) {
+            reportProgress([NSString stringWithFormat:@"Skipping %@ (unchanged)\n", frameworkName]);
+            module = [OCDModule moduleWithName:[frameworkName stringByDeletingPathExtension] differenceType:OCDifferenceTypeModification differences:@[]];
+        } else {
+            reportProgress([NSString stringWithFormat:@"Comparing %@\n", frameworkName]);
+            module = ModuleForSDKFramework(index, frameworkName,
+                                           oldFrameworks[frameworkName], oldCompilerArguments, oldPreambles[frameworkName],
+                                           newFrameworks[frameworkName], newCompilerArguments, newPreambles[frameworkName]);
+        }
 
-                PLClangTranslationUnit *newTU = TranslationUnitForSDKFramework(index, newPath, newCompilerArguments);
-                if (newTU == nil) {
-                    continue;
-                }
+        if (module != nil) {
+            [manifest setModule:module inputs:frameworkInputs[frameworkName] forFramework:frameworkName];
+        }
 
-                OCDAPISource *oldSource = [OCDAPISource APISourceWithTranslationUnit:oldTU containingPath:oldPath includeSystemHeaders:YES];
-                OCDAPISource *newSource = [OCDAPISource APISourceWithTranslationUnit:newTU containingPath:newPath includeSystemHeaders:YES];
-                NSArray<OCDifference *> *differences = [OCDAPIComparator differencesBetweenOldAPISource:oldSource newAPISource:newSource];
+        return module;
+    };
 
-                [modules addObject:[OCDModule moduleWithName:[frameworkName stringByDeletingPathExtension]
-                                              differenceType:OCDifferenceTypeModification
-                                                 differences:differences]];
-            } else {
-                PLClangTranslationUnit *newTU = TranslationUnitForSDKFramework(index, newPath, newCompilerArguments);
-                if (newTU == nil) {
-                    continue;
-                }
+    if (jobs <= 1) {
+        PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:PLClangIndexCreationExcludePCHDeclarations];
 
-                OCDAPISource *newSource = [OCDAPISource APISourceWithTranslationUnit:newTU containingPath:newPath includeSystemHeaders:YES];
-                NSArray<OCDifference *> *differences = [OCDAPIComparator differencesBetweenOldAPISource:nil newAPISource:newSource];
+        for (NSString *frameworkName in orderedFrameworks) {
+            @autoreleasepool {
+                OCDModule *module = moduleForFramework(index, frameworkName, ^(NSString *message) {
+                    fprintf(stderr, "%s", [message UTF8String]);
+                });
 
-                [modules addObject:[OCDModule moduleWithName:[frameworkName stringByDeletingPathExtension]
-                                              differenceType:OCDifferenceTypeAddition
-                                                 differences:differences]];
+                if (module != nil) {
+                    moduleHandler(module);
+                }
             }
         }
+    } else {
+        // Each worker owns a source index and claims whole frameworks until none remain. Results and
+        // progress messages are held by framework position in a reorder buffer until every earlier
+        // framework has completed, then handed in order to a serial writer queue that reports and
+        // releases them, so the output matches a serial run regardless of which worker finishes first.
+        // A worker claims a framework only while fewer than twice as many frameworks as there are workers are
+        // being compared or awaiting their report, which bounds the number of modules held in memory.
+        NSMutableArray *progressMessages = [NSMutableArray arrayWithCapacity:slotCount];
+        NSMutableArray *frameworkModules = [NSMutableArray arrayWithCapacity:slotCount];
+        for (NSUInteger i = 0; i < slotCount; i++) {
+            [progressMessages addObject:[NSNull null]];
+            [frameworkModules addObject:[NSNull null]];
+        }
+        NSMutableIndexSet *completedFrameworks = [NSMutableIndexSet indexSet];
+
+        __block NSUInteger nextFramework = 0;
+        __block NSUInteger nextReportedFramework = 0;
+        dispatch_queue_t resultQueue = dispatch_queue_create("objc-diff.sdk-results", DISPATCH_QUEUE_SERIAL);
+        dispatch_queue_t writerQueue = dispatch_queue_create("objc-diff.sdk-writer", DISPATCH_QUEUE_SERIAL);
+        dispatch_queue_t workerQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+        dispatch_group_t group = dispatch_group_create();
+        dispatch_semaphore_t pendingSemaphore = dispatch_semaphore_create(jobs * 2);
+
+        for (NSUInteger worker = 0; worker < MIN(jobs, slotCount); worker++) {
+            dispatch_group_async(group, workerQueue, ^{
+                PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:PLClangIndexCreationExcludePCHDeclarations];
+
+                while (YES) {
+                    // The earliest framework not yet reported always holds a slot, so waiting cannot deadlock
+                    dispatch_semaphore_wait(pendingSemaphore, DISPATCH_TIME_FOREVER);
+
+                    __block NSUInteger frameworkIndex;
+                    dispatch_sync(resultQueue, ^{
+                        frameworkIndex = nextFramework++;
+                    });
+
+                    if (frameworkIndex >= slotCount) {
+                        dispatch_semaphore_signal(pendingSemaphore);
+                        break;
+                    }
+
+                    @autoreleasepool {
+                        __block NSString *progressMessage;
+                        OCDModule *module = moduleForFramework(index, orderedFrameworks[frameworkIndex], ^(NSString *message) {
+                            progressMessage = message;
+                        });
+
+                        dispatch_sync(resultQueue, ^{
+                            if (progressMessage != nil) {
+                                progressMessages[frameworkIndex] = progressMessage;
+                            }
+                            if (module != nil) {
+                                frameworkModules[frameworkIndex] = module;
+                            }
+                            [completedFrameworks addIndex:frameworkIndex];
+
+                            while ([completedFrameworks containsIndex:nextReportedFramework]) {
+                                id readyMessage = progressMessages[nextReportedFramework];
+                                id readyModule = frameworkModules[nextReportedFramework];
+                                progressMessages[nextReportedFramework] = [NSNull null];
+                                frameworkModules[nextReportedFramework] = [NSNull null];
+                                nextReportedFramework++;
+
+                                // Enqueued while the result queue is held, so reports are written in framework order
+                                dispatch_group_async(group, writerQueue, ^{
+                                    @autoreleasepool {
+                                        if (readyMessage != [NSNull null]) {
+                                            fprintf(stderr, "%s", [readyMessage UTF8String]);
+                                        }
+                                        if (readyModule != [NSNull null]) {
+                                            moduleHandler(readyModule);
+                                        }
+                                    }
+
+                                    dispatch_semaphore_signal(pendingSemaphore);
+                                });
+                            }
+                        });
+                    }
+                }
+            });
+        }
+
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
     }
 
-    [modules sortUsingComparator:^NSComparisonResult(OCDModule *obj1, OCDModule *obj2) {
-        return [obj1.name localizedStandardCompare:obj2.name];
-    }];
+    NSTimeInterval recomputeTime = -[recomputeStartDate timeIntervalSinceNow];
+
+    if (cache != nil) {
+        NSError *error;
+        if ([cache storeData:[manifest data] forKey:manifestKey extension:@"manifest" error:&error] == nil) {
+            fprintf(stderr, "Could not write SDK manifest: %s\n", [[error localizedDescription] UTF8String]);
+        }
+    }
+
+    if (printStatistics) {
+        NSMutableSet *skippedFrameworks = [unchangedFrameworks mutableCopy];
+        [skippedFrameworks minusSet:[NSSet setWithArray:unsupportedFrameworks]];
+        [skippedFrameworks minusSet:reusedFrameworks];
+        NSUInteger recomputedCount = [frameworkInputs count] - [reusedFrameworks count] - [skippedFrameworks count];
+
+        fprintf(stderr, "Reused %lu of %lu frameworks from the previous comparison, hashed and matched in %.2fs\n",
+                (unsigned long)[reusedFrameworks count], (unsigned long)frameworkCount, reuseTime);
+        fprintf(stderr, "Skipped %lu frameworks with unchanged headers\n", (unsigned long)[skippedFrameworks count]);
+        fprintf(stderr, "Recomputed %lu frameworks in %.2fs\n", (unsigned long)recomputedCount, recomputeTime);
+    }
+
+    if (printStatistics && oldPreambles != nil) {
+        PrintPrecompiledHeaderStatistics(oldSDKPath, oldLayers);
+    }
+
+    if (printStatistics && newPreambles != nil) {
+        PrintPrecompiledHeaderStatistics(newSDKPath, newLayers);
+    }
+}
+
+static OCDAPISnapshot *ReadSnapshot(NSString *path) {
+    NSError *error;
+    OCDAPISnapshot *snapshot = [OCDAPISnapshot snapshotWithContentsOfFile:path error:&error];
+    if (snapshot == nil) {
+        fprintf(stderr, "Could not read API snapshot %s: %s\n", [path UTF8String], [[error localizedDescription] UTF8String]);
+    }
 
-    return [OCDAPIDifferences APIDifferencesWithModules:modules];
+    return snapshot;
 }
 
 static BOOL ArrayContainsStringWithPrefix(NSArray *array, NSString *prefix) {
@@ -333,6 +1319,149 @@ static void ApplySDKToCompilerArguments(OCDSDK *sdk, NSMutableArray *compilerArg
     }
 }
 
+/**
+ * Returns the directory within the cache directory used to cache Clang modules across runs, creating it if necessary.
+ *
+ * Clang keys the modules in the cache by the compiler arguments and SDK they were built with, so a single directory
+ * is shared by all API versions.
+ */
+static NSString *ModuleCachePath(NSString *cacheDirectory) {
+    NSString *moduleCachePath = [cacheDirectory stringByAppendingPathComponent:@"ModuleCache"];
+
+    NSError *error;
+    if ([[NSFileManager defaultManager] createDirectoryAtPath:moduleCachePath withIntermediateDirectories:YES attributes:nil error:&error] == NO) {
+        fprintf(stderr, "Could not create module cache directory %s: %s\n", [moduleCachePath UTF8String], [[error localizedDescription] UTF8String]);
+        return nil;
+    }
+
+    return moduleCachePath;
+}
+
+static void ApplyModulesToCompilerArguments(NSString *moduleCachePath, NSMutableArray *compilerArguments) {
+    if ([compilerArguments containsObject:@"-fmodules"] == NO) {
+        [compilerArguments addObject:@"-fmodules"];
+    }
+
+    if (ArrayContainsStringWithPrefix(compilerArguments, @"-fmodules-cache-path=") == NO) {
+        [compilerArguments addObject:[@"-fmodules-cache-path=" stringByAppendingString:moduleCachePath]];
+    }
+}
+
+/**
+ * Returns the compiler arguments that a precompiled preamble of SDK headers is built with.
+ *
+ * Search paths for the API's own headers do not affect the SDK's headers and Clang does not require them to match
+ * when including a precompiled header, so they are removed. This allows the old and new versions of an API, and
+ * successive versions of it across runs, to share a single preamble.
+ */
+static NSArray *SDKPreambleCompilerArguments(NSArray *compilerArguments) {
+    NSArray *searchPathOptions = @[@"-I", @"-iquote", @"-F"];
+    NSMutableArray *preambleArguments = [NSMutableArray array];
+
+    for (NSUInteger i = 0; i < [compilerArguments count]; i++) {
+        NSString *argument = compilerArguments[i];
+        BOOL isSearchPath = NO;
+
+        for (NSString *option in searchPathOptions) {
+            if ([argument isEqualToString:option]) {
+                // The path is a separate argument
+                isSearchPath = YES;
+                i++;
+                break;
+            } else if ([argument hasPrefix:option]) {
+                isSearchPath = YES;
+                break;
+            }
+        }
+
+        if (isSearchPath == NO) {
+            [preambleArguments addObject:argument];
+        }
+    }
+
+    return preambleArguments;
+}
+
+/**
+ * Returns the source of the precompiled preamble of the specified SDK's system headers.
+ *
+ * Nearly all of the time spent parsing a typical library is spent parsing Foundation and the platform's UI
+ * framework, so these are included if present in the SDK.
+ */
+static NSString *SDKPreambleSource(OCDSDK *sdk) {
+    NSMutableArray *frameworkNames = [NSMutableArray arrayWithObject:@"Foundation"];
+    switch (sdk.platform) {
+        case OCDPlatformMacOS:
+            [frameworkNames addObject:@"AppKit"];
+            break;
+        case OCDPlatformIOS:
+        case OCDPlatformTVOS:
+            [frameworkNames addObject:@"UIKit"];
+            break;
+        case OCDPlatformWatchOS:
+            break;
+    }
+
+    NSMutableString *source = [NSMutableString string];
+    NSString *frameworksPath = [sdk.path stringByAppendingPathComponent:@"System/Library/Frameworks"];
+    for (NSString *frameworkName in frameworkNames) {
+        NSString *frameworkPath = [frameworksPath stringByAppendingPathComponent:[frameworkName stringByAppendingPathExtension:@"framework"]];
+        if ([[NSFileManager defaultManager] fileExistsAtPath:frameworkPath]) {
+            [source appendFormat:@"#import <%@/%@.h>\n", frameworkName, frameworkName];
+        }
+    }
+
+    return source;
+}
+
+/**
+ * Ensures the persistent cache holds a precompiled preamble of the specified SDK's system headers for the specified
+ * compiler arguments, building and storing one if necessary.
+ *
+ * The preamble is keyed by the Clang version, the SDK's path and version, and the normalized compiler arguments, so
+ * any change to these selects a different entry. Returns the key of the entry, or nil if no preamble is available.
+ */
+static NSString *CachedSDKPreambleKey(OCDCache *cache, OCDSDK *sdk, NSArray *compilerArguments, BOOL printStatistics) {
+    NSString *source = SDKPreambleSource(sdk);
+    if ([source length] == 0) {
+        return nil;
+    }
+
+    NSArray *preambleArguments = SDKPreambleCompilerArguments(compilerArguments);
+    NSMutableArray *keyComponents = [NSMutableArray arrayWithObjects:
+                                     @"sdk-preamble",
+                                     PLClangGetVersionString(),
+                                     [sdk.path stringByStandardizingPath],
+                                     sdk.version ?: @"",
+                                     sdk.platformBuild ?: @"",
+                                     source,
+                                     nil];
+    [keyComponents addObjectsFromArray:preambleArguments];
+    NSString *key = [OCDCache keyForComponents:keyComponents];
+
+    if ([cache pathForKey:key extension:@"pch"] != nil) {
+        if (printStatistics) {
+            fprintf(stderr, "SDK preamble for %s: cached\n", [sdk.path UTF8String]);
+        }
+
+        return key;
+    }
+
+    // Concurrent processes may build the same preamble, in which case each publishes an identical entry
+    NSError *error;
+    OCDPrecompiledHeader *preamble = [OCDPrecompiledHeader precompiledHeaderWithSource:source compilerArguments:preambleArguments error:&error];
+    if (preamble == nil || [cache storeFileAtPath:preamble.path forKey:key extension:@"pch" error:&error] == nil) {
+        fprintf(stderr, "Could not cache SDK preamble for %s: %s\n", [sdk.path UTF8String], [[error localizedDescription] UTF8String]);
+        return nil;
+    }
+
+    if (printStatistics) {
+        fprintf(stderr, "SDK preamble for %s: %lu headers, built in %.2fs\n", [sdk.path UTF8String], (unsigned long)preamble.headerCount, preamble.buildTime);
+    }
+
+    return key;
+}
+
 static NSArray *GetCompilerArguments(int argc, char *argv[]) {
     NSMutableArray *arguments = [[NSMutableArray alloc] init];
 
@@ -356,6 +1485,14 @@ int main(int argc, char *argv[]) {
         NSString *title;
         NSString *linkMapPath;
         NSString *htmlOutputDirectory;
+        NSString *oldSnapshotPath;
+        NSString *newSnapshotPath;
+        NSString *saveSnapshotPath;
+        NSUInteger jobs = 1;
+        BOOL printStatistics = NO;
+        BOOL useModules = NO;
+        BOOL useCache = YES;
+        NSString *cacheDirectory = [OCDCache defaultDirectory];
         NSMutableArray *oldCompilerArguments = [NSMutableArray arrayWithObjects:@"-x", @"objective-c-header", nil];
         NSMutableArray *newCompilerArguments = [oldCompilerArguments mutableCopy];
         int reportTypes = 0;
@@ -374,6 +1511,14 @@ int main(int argc, char *argv[]) {
             { "args",         no_argument,        NULL,          'A' },
             { "oldargs",      no_argument,        NULL,          'O' },
             { "newargs",      no_argument,        NULL,          'N' },
+            { "jobs",         required_argument,  NULL,          'j' },
+            { "old-snapshot", required_argument,  NULL,          'P' },
+            { "new-snapshot", required_argument,  NULL,          'Q' },
+            { "save-snapshot", required_argument, NULL,          'S' },
+            { "modules",      no_argument,        NULL,          'm' },
+            { "cache-dir",    required_argument,  NULL,          'C' },
+            { "no-cache",     no_argument,        NULL,          'c' },
+            { "stats",        no_argument,        NULL,          'M' },
             { "version",      no_argument,        NULL,          'v' },
             { NULL,           0,                  NULL,           0  }
         };
@@ -408,6 +1553,39 @@ int main(int argc, char *argv[]) {
                 case 'n':
                     newPath = @(optarg);
                     break;
+                case 'j':
+                {
+                    char *end;
+                    unsigned long value = strtoul(optarg, &end, 10);
+                    if (*optarg == '\0' || *end != '\0' || value < 1) {
+                        fprintf(stderr, "Invalid job count \"%s\"\n", optarg);
+                        return 1;
+                    }
+
+                    jobs = value;
+                    break;
+                }
+                case 'P':
+                    oldSnapshotPath = @(optarg);
+                    break;
+                case 'Q':
+                    newSnapshotPath = @(optarg);
+                    break;
+                case 'S':
+                    saveSnapshotPath = @(optarg);
+                    break;
+                case 'm':
+                    useModules = YES;
+                    break;
+                case 'C':
+                    cacheDirectory = [@(optarg) ocd_absolutePath];
+                    break;
+                case 'c':
+                    useCache = NO;
+                    break;
+                case 'M':
+                    printStatistics = YES;
+                    break;
                 case 'v':
                 {
                     NSBundle *bundle = [NSBundle mainBundle];
@@ -459,12 +1637,22 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        if ([newPath length] < 1) {
+        if ([newPath length] < 1 && newSnapshotPath == nil) {
             fprintf(stderr, "No new API path specified\n");
             PrintUsage();
             return 1;
         }
 
+        if (oldPath != nil && oldSnapshotPath != nil) {
+            fprintf(stderr, "Only one of --old or --old-snapshot may be specified\n");
+            return 1;
+        }
+
+        if (newPath != nil && newSnapshotPath != nil) {
+            fprintf(stderr, "Only one of --new or --new-snapshot may be specified\n");
+            return 1;
+        }
+
         if ((reportTypes & OCDReportTypeText) && (reportTypes & OCDReportTypeXML)) {
             fprintf(stderr, "Only one of --text or --xml may be specified\n");
             return 1;
@@ -495,7 +1683,13 @@ int main(int argc, char *argv[]) {
             return 1;
         }
 
-        if (oldSDK == nil || newSDK == nil) {
+        if (newPathIsSDK && (oldSnapshotPath != nil || newSnapshotPath != nil || saveSnapshotPath != nil)) {
+            fprintf(stderr, "API snapshots are not supported when comparing SDKs\n");
+            return 1;
+        }
+
+        // An SDK is only needed for the API versions that are parsed from headers
+        if ((oldPath != nil && oldSDK == nil) || (newPath != nil && newSDK == nil)) {
             defaultSDK = [OCDSDK SDKForName:sdkName];
             if (defaultSDK == nil) {
                 fprintf(stderr, "Could not locate SDK \"%s\"\n", [sdkName UTF8String]);
@@ -503,70 +1697,208 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        ApplySDKToCompilerArguments(oldSDK ?: defaultSDK, oldCompilerArguments);
-        ApplySDKToCompilerArguments(newSDK ?: defaultSDK, newCompilerArguments);
-
-        OCDAPIDifferences *differences;
-
-        if (oldPathIsSDK) {
-            differences = DiffSDKs(oldPath, oldCompilerArguments, newPath, newCompilerArguments);
-        } else {
-            PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:0];
-
-            OCDAPISource *oldSource;
-            if (oldPath != nil) {
+        if (oldPath != nil) {
+            ApplySDKToCompilerArguments(oldSDK ?: defaultSDK, oldCompilerArguments);
+        }
 
-                if (oldSDK != nil) {
-                    PLClangTranslationUnit *oldTU = TranslationUnitForSDKFramework(index, oldPath, oldCompilerArguments);
-                    oldSource = [OCDAPISource APISourceWithTranslationUnit:oldTU containingPath:oldPath includeSystemHeaders:YES];
-                } else {
-                    PLClangTranslationUnit *oldTU = TranslationUnitForPath(index, oldPath, oldCompilerArguments, YES);
-                    oldSource = [OCDAPISource APISourceWithTranslationUnit:oldTU];
-                }
+        if (newPath != nil) {
+            ApplySDKToCompilerArguments(newSDK ?: defaultSDK, newCompilerArguments);
+        }
 
-                if (oldSource == nil) {
-                    return 1;
-                }
+        if (useModules) {
+            NSString *moduleCachePath = ModuleCachePath(cacheDirectory);
+            if (moduleCachePath == nil) {
+                return 1;
             }
 
-            OCDAPISource *newSource;
+            // Modules are only used for frameworks within an SDK
+            if (oldSDK != nil) {
+                ApplyModulesToCompilerArguments(moduleCachePath, oldCompilerArguments);
+            }
 
             if (newSDK != nil) {
-                PLClangTranslationUnit *newTU = TranslationUnitForSDKFramework(index, newPath, newCompilerArguments);
-                newSource = [OCDAPISource APISourceWithTranslationUnit:newTU containingPath:newPath includeSystemHeaders:YES];
-            } else {
-                PLClangTranslationUnit *newTU = TranslationUnitForPath(index, newPath, newCompilerArguments, YES);
-                newSource = [OCDAPISource APISourceWithTranslationUnit:newTU];
+                ApplyModulesToCompilerArguments(moduleCachePath, newCompilerArguments);
             }
+        }
 
-            if (newSource == nil) {
+        __block OCDAPISnapshot *oldSnapshot;
+        if (oldSnapshotPath != nil) {
+            oldSnapshot = ReadSnapshot(oldSnapshotPath);
+            if (oldSnapshot == nil) {
                 return 1;
             }
+        }
 
-            NSString *moduleName = [[newPath lastPathComponent] stringByDeletingPathExtension];
-            NSArray<OCDifference *> *moduleDifferences = [OCDAPIComparator differencesBetweenOldAPISource:oldSource newAPISource:newSource];
-            OCDModule *module = [OCDModule moduleWithName:moduleName differenceType:OCDifferenceTypeModification differences:moduleDifferences];
-            differences = [OCDAPIDifferences APIDifferencesWithModules:@[module]];
+        __block OCDAPISnapshot *newSnapshot;
+        if (newSnapshotPath != nil) {
+            newSnapshot = ReadSnapshot(newSnapshotPath);
+            if (newSnapshot == nil) {
+                return 1;
+            }
+        }
+
+        [OCDCursor setCollectsStatistics:printStatistics];
+
+        // The cache holds SDK manifests and the preambles and parse results of APIs outside of an SDK
+        OCDCache *cache;
+        if (useCache && (oldPathIsSDK || (oldPath != nil && oldSDK == nil) || (newPath != nil && newSDK == nil))) {
+            NSError *error;
+            cache = [OCDCache cacheWithDirectory:cacheDirectory error:&error];
+            if (cache == nil) {
+                fprintf(stderr, "Could not create cache directory %s: %s\n", [cacheDirectory UTF8String], [[error localizedDescription] UTF8String]);
+            }
         }
 
         if (reportTypes == 0) {
             reportTypes = OCDReportTypeText;
         }
 
+        NSMutableArray<id<OCDReportGenerator>> *generators = [NSMutableArray array];
+
         if (reportTypes & OCDReportTypeText) {
-            OCDTextReportGenerator *generator = [[OCDTextReportGenerator alloc] init];
-            [generator generateReportForDifferences:differences title:title];
+            [generators addObject:[[OCDTextReportGenerator alloc] init]];
         }
 
         if (reportTypes & OCDReportTypeXML) {
-            OCDXMLReportGenerator *generator = [[OCDXMLReportGenerator alloc] init];
-            [generator generateReportForDifferences:differences title:title];
+            [generators addObject:[[OCDXMLReportGenerator alloc] init]];
         }
 
         if (reportTypes & OCDReportTypeHTML) {
             OCDLinkMap *linkMap = [[OCDLinkMap alloc] initWithPath:linkMapPath];
-            OCDHTMLReportGenerator *htmlGenerator = [[OCDHTMLReportGenerator alloc] initWithOutputDirectory:htmlOutputDirectory linkMap:linkMap];
-            [htmlGenerator generateReportForDifferences:differences title:title];
+            [generators addObject:[[OCDHTMLReportGenerator alloc] initWithOutputDirectory:htmlOutputDirectory linkMap:linkMap]];
+        }
+
+        if (oldPathIsSDK) {
+            // Each framework's module is written to the reports as soon as it is available and then released. As
+            // with other comparisons the report covers multiple modules unless there is exactly one, so the first
+            // module is held until a second arrives or the comparison ends.
+            __block OCDModule *firstModule = nil;
+            __block BOOL reportBegun = NO;
+            void (^beginReport)(BOOL) = ^(BOOL multipleModules) {
+                for (id<OCDReportGenerator> generator in generators) {
+                    [generator beginReportWithTitle:title multipleModules:multipleModules];
+                    if (firstModule != nil) {
+                        [generator reportModule:firstModule];
+                    }
+                }
+
+                firstModule = nil;
+                reportBegun = YES;
+            };
+
+            DiffSDKs(oldSDK, oldCompilerArguments, newSDK, newCompilerArguments, jobs, cache, printStatistics, ^(OCDModule *module) {
+                if (!reportBegun) {
+                    if (firstModule == nil) {
+                        firstModule = module;
+                        return;
+                    }
+
+                    beginReport(YES);
+                }
+
+                for (id<OCDReportGenerator> generator in generators) {
+                    [generator reportModule:module];
+                }
+            });
+
+            if (!reportBegun) {
+                beginReport(firstModule == nil);
+            }
+        } else {
+            // An API outside of an SDK whose headers have not changed since a previous parse is loaded from the
+            // parse cache as a snapshot
+            OCDParseCache *parseCache = cache ? [[OCDParseCache alloc] initWithCache:cache] : nil;
+            NSString *oldParseCacheKey = (parseCache && oldPath && oldSDK == nil) ? ParseCacheKeyForPath(oldPath, defaultSDK, oldCompilerArguments) : nil;
+            NSString *newParseCacheKey = (parseCache && newPath && newSDK == nil) ? ParseCacheKeyForPath(newPath, defaultSDK, newCompilerArguments) : nil;
+
+            if (oldParseCacheKey != nil) {
+                oldSnapshot = [parseCache snapshotForKey:oldParseCacheKey];
+            }
+
+            if (newParseCacheKey != nil) {
+                newSnapshot = [parseCache snapshotForKey:newParseCacheKey];
+            }
+
+            BOOL parseOld = (oldPath != nil && oldSnapshot == nil);
+            BOOL parseNew = (newPath != nil && newSnapshot == nil);
+
+            // APIs outside of an SDK are parsed on top of a precompiled preamble of the SDK's system headers that
+            // persists across runs. The preambles are prepared before parsing so that old and new API versions
+            // built with the same SDK and arguments share one.
+            NSString *oldPreambleKey = (cache && parseOld && oldSDK == nil) ? CachedSDKPreambleKey(cache, defaultSDK, oldCompilerArguments, printStatistics) : nil;
+            NSString *newPreambleKey = (cache && parseNew && newSDK == nil) ? CachedSDKPreambleKey(cache, defaultSDK, newCompilerArguments, printStatistics) : nil;
+
+            // The old and new APIs are independent until they are compared, so parse and extract each on its
+            // own source index concurrently. No index is created for a version that was loaded from a snapshot.
+            // Each version is extracted to a snapshot as soon as it has been parsed and its translation unit is
+            // then disposed of, so the comparison itself holds only the two snapshots.
+            PLClangSourceIndex *oldIndex = parseOld ? [PLClangSourceIndex indexWithOptions:(oldPreambleKey ? PLClangIndexCreationExcludePCHDeclarations : 0)] : nil;
+            PLClangSourceIndex *newIndex = parseNew ? [PLClangSourceIndex indexWithOptions:(newPreambleKey ? PLClangIndexCreationExcludePCHDeclarations : 0)] : nil;
+            dispatch_queue_t queue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+            dispatch_group_t group = dispatch_group_create();
+
+            if (parseOld) {
+                dispatch_group_async(group, queue, ^{
+                    @autoreleasepool {
+                        OCDAPISource *source = APISourceForPath(oldIndex, oldPath, oldSDK, oldCompilerArguments, cache, oldPreambleKey);
+                        if (source != nil) {
+                            oldSnapshot = SnapshotForParsedAPI(source, [OCDAPIComparator APIForSource:source], parseCache, oldParseCacheKey);
+                        }
+                    }
+                });
+            }
+
+            if (parseNew) {
+                dispatch_group_async(group, queue, ^{
+                    @autoreleasepool {
+                        OCDAPISource *source = APISourceForPath(newIndex, newPath, newSDK, newCompilerArguments, cache, newPreambleKey);
+                        if (source != nil) {
+                            newSnapshot = SnapshotForParsedAPI(source, [OCDAPIComparator APIForSource:source], parseCache, newParseCacheKey);
+                        }
+                    }
+                });
+            }
+
+            dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+            if ((parseOld && oldSnapshot == nil) || (parseNew && newSnapshot == nil)) {
+                return 1;
+            }
+
+            if (printStatistics && parseCache != nil) {
+                fprintf(stderr, "Parse cache: %lu hits, %lu misses\n", (unsigned long)parseCache.hitCount, (unsigned long)parseCache.missCount);
+            }
+
+            NSString *moduleName = [[(newPath ?: newSnapshotPath) lastPathComponent] stringByDeletingPathExtension];
+
+            if (oldSnapshot == nil) {
+                oldSnapshot = [[[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:nil targetPlatformName:nil] snapshot];
+            }
+
+            if (saveSnapshotPath != nil) {
+                NSError *error;
+                if ([newSnapshot writeToFile:saveSnapshotPath error:&error] == NO) {
+                    fprintf(stderr, "Could not write API snapshot to %s: %s\n", [saveSnapshotPath UTF8String], [[error localizedDescription] UTF8String]);
+                    return 1;
+                }
+            }
+
+            NSArray<OCDifference *> *moduleDifferences = [OCDAPISnapshotComparator differencesBetweenOldSnapshot:oldSnapshot newSnapshot:newSnapshot];
+
+            OCDModule *module = [OCDModule moduleWithName:moduleName differenceType:OCDifferenceTypeModification differences:moduleDifferences];
+
+            for (id<OCDReportGenerator> generator in generators) {
+                [generator beginReportWithTitle:title multipleModules:NO];
+                [generator reportModule:module];
+            }
+        }
+
+        for (id<OCDReportGenerator> generator in generators) {
+            [generator endReport];
+        }
+
+        if (printStatistics) {
+            PrintCursorStatistics();
         }
     }
 
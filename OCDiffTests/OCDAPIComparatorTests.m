@@ -1,11 +1,22 @@
 #import <XCTest/XCTest.h>
 #import <ObjectDoc/ObjectDoc.h>
 #import "OCDAPIComparator.h"
+#import "OCDAPISnapshot.h"
+#import "OCDAPISnapshotComparator.h"
 
 static NSString * const OCDOldTestPath = @"old/test.h";
 static NSString * const OCDNewTestPath = @"new/test.h";
 static NSString * const OCDTestPath = @"test.h";
 
+/**
+ * The comparison of cursors that OCDAPISnapshotComparator is checked against.
+ */
+@interface OCDAPIComparator (ReferenceComparison)
+
++ (NSArray<OCDifference *> *)differencesBetweenOldTranslationUnit:(PLClangTranslationUnit *)oldTranslationUnit newTranslationUnit:(PLClangTranslationUnit *)newTranslationUnit;
+
+@end
+
 @interface OCDAPIComparatorTests : XCTestCase
 @end
 
@@ -962,6 +973,28 @@ static NSString * const OCDTestPath = @"test.h";
     XCTAssertEqualObjects(differences, expectedDifferences);
 }
 
+/**
+ * Tests that implicit accessors are matched to the property that declared them when several properties share a line.
+ */
+- (void)testConversionToPropertiesOnSameLine {
+    NSArray *differences = [self differencesBetweenOldSource:@"@interface Test - (int)first; - (long)second; @end"
+                                                   newSource:@"@interface Test @property (readonly) int first; @property (readonly) long second; @end"];
+
+    OCDModification *firstModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                 previousValue:@"- (int)first"
+                                                                  currentValue:@"@property (readonly) int first"];
+
+    OCDModification *secondModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                  previousValue:@"- (long)second"
+                                                                   currentValue:@"@property (readonly) long second"];
+
+    NSArray *expectedDifferences = @[
+        [OCDifference modificationDifferenceWithName:@"-[Test first]" path:OCDTestPath lineNumber:1 modifications:@[firstModification]],
+        [OCDifference modificationDifferenceWithName:@"-[Test second]" path:OCDTestPath lineNumber:1 modifications:@[secondModification]]
+    ];
+    XCTAssertEqualObjects(differences, expectedDifferences);
+}
+
 /**
  * Tests that a conversion from explicit accessors to a property with a different implicit accessor reports removal of the previous explicit accessor.
  */
@@ -1375,6 +1408,16 @@ static NSString * const OCDTestPath = @"test.h";
     XCTAssertEqualObjects(differences, expectedDifferences);
 }
 
+/**
+ * Tests that forward declarations following a class are not recorded as references made by the class.
+ */
+- (void)testForwardDeclarationsFollowingClass {
+    NSArray *differences = [self differencesBetweenOldSource:@"@protocol A @end @interface Test <A> @end"
+                                                   newSource:@"@protocol A @end @interface Test <A> @end @protocol B; @class C;"];
+
+    XCTAssertEqualObjects(differences, @[]);
+}
+
 /**
  * Tests that a declaration begining with a '_' and all of its children are ignored.
  */
@@ -1470,6 +1513,70 @@ static NSString * const OCDTestPath = @"test.h";
                       addition:@"id objc_msgSend(id self, SEL op, ...);"];
 }
 
+/**
+ * Tests an API large enough for matched declarations to be compared in several concurrent chunks, including a
+ * conversion to a property whose removal must be suppressed after the chunks are merged.
+ */
+- (void)testManyDeclarations {
+    NSMutableString *oldSource = [NSMutableString string];
+    NSMutableString *newSource = [NSMutableString string];
+    for (NSUInteger i = 0; i < 3000; i++) {
+        [oldSource appendFormat:@"void Test%lu(void);\n", (unsigned long)i];
+        [newSource appendFormat:@"%@ Test%lu(void);\n", (i == 1000 || i == 2000) ? @"int" : @"void", (unsigned long)i];
+    }
+
+    [oldSource appendString:@"@interface Test - (int)testProperty; - (void)setTestProperty:(int)val; @end"];
+    [newSource appendString:@"@interface Test @property int testProperty; @end"];
+
+    NSArray *differences = [self differencesBetweenOldSource:oldSource newSource:newSource];
+
+    OCDModification *firstModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                 previousValue:@"void Test1000(void)"
+                                                                  currentValue:@"int Test1000(void)"];
+
+    OCDModification *secondModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                  previousValue:@"void Test2000(void)"
+                                                                   currentValue:@"int Test2000(void)"];
+
+    OCDModification *getterModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                  previousValue:@"- (int)testProperty"
+                                                                   currentValue:@"@property int testProperty"];
+
+    OCDModification *setterModification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                                  previousValue:@"- (void)setTestProperty:(int)val"
+                                                                   currentValue:@"@property int testProperty"];
+
+    NSArray *expectedDifferences = @[
+        [OCDifference modificationDifferenceWithName:@"Test1000()" path:OCDTestPath lineNumber:1001 modifications:@[firstModification]],
+        [OCDifference modificationDifferenceWithName:@"Test2000()" path:OCDTestPath lineNumber:2001 modifications:@[secondModification]],
+        [OCDifference modificationDifferenceWithName:@"-[Test setTestProperty:]" path:OCDTestPath lineNumber:3001 modifications:@[setterModification]],
+        [OCDifference modificationDifferenceWithName:@"-[Test testProperty]" path:OCDTestPath lineNumber:3001 modifications:@[getterModification]]
+    ];
+    XCTAssertEqualObjects(differences, expectedDifferences);
+}
+
+/**
+ * Tests that a declaration in an unchanged header is still compared when it is redeclared in another header.
+ */
+- (void)testRedeclarationInOtherHeader {
+    NSString *headerSource = @"@interface Test - (void)testMethod; @end\n";
+    NSArray *headerFiles = @[
+        [PLClangUnsavedFile unsavedFileWithPath:@"old/Header.h" data:[headerSource dataUsingEncoding:NSUTF8StringEncoding]],
+        [PLClangUnsavedFile unsavedFileWithPath:@"new/Header.h" data:[headerSource dataUsingEncoding:NSUTF8StringEncoding]]
+    ];
+
+    NSArray *differences = [self differencesBetweenOldSource:@"#import \"Header.h\"\n@interface Test (NSDeprecated) @end"
+                                                   newSource:@"#import \"Header.h\"\n@interface Test (NSDeprecated) - (void)testMethod; @end"
+                                             additionalFiles:headerFiles
+                                         additionalArguments:nil];
+
+    OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeAvailability
+                                                            previousValue:@"Available"
+                                                             currentValue:@"Deprecated"];
+    NSArray *expectedDifferences = @[[OCDifference modificationDifferenceWithName:@"-[Test testMethod]" path:OCDTestPath lineNumber:2 modifications:@[modification]]];
+    XCTAssertEqualObjects(differences, expectedDifferences);
+}
+
 /**
  * Tests that macros defined via compiler arguments are ignored.
  */
@@ -1581,7 +1688,21 @@ static NSString * const OCDTestPath = @"test.h";
     XCTAssertNotNil(newTU, @"Failed to parse: %@", error);
     XCTAssertFalse(newTU.didFail, @"Fatal error encountered during parse");
 
-    return [OCDAPIComparator differencesBetweenOldTranslationUnit:oldTU newTranslationUnit:newTU];
+    NSArray *differences = [OCDAPIComparator differencesBetweenOldTranslationUnit:oldTU newTranslationUnit:newTU];
+
+    // Verify that comparing snapshots of the two APIs, as loaded from their serialized form, produces the same
+    // differences as comparing the translation units directly.
+    NSData *oldSnapshotData = [OCDAPIComparator snapshotForAPISource:[OCDAPISource APISourceWithTranslationUnit:oldTU]].data;
+    NSData *newSnapshotData = [OCDAPIComparator snapshotForAPISource:[OCDAPISource APISourceWithTranslationUnit:newTU]].data;
+    OCDAPISnapshot *oldSnapshot = [OCDAPISnapshot snapshotWithData:oldSnapshotData error:&error];
+    XCTAssertNotNil(oldSnapshot, @"Failed to load snapshot: %@", error);
+    OCDAPISnapshot *newSnapshot = [OCDAPISnapshot snapshotWithData:newSnapshotData error:&error];
+    XCTAssertNotNil(newSnapshot, @"Failed to load snapshot: %@", error);
+
+    NSArray *snapshotDifferences = [OCDAPISnapshotComparator differencesBetweenOldSnapshot:oldSnapshot newSnapshot:newSnapshot];
+    XCTAssertEqualObjects(snapshotDifferences, differences, @"Snapshot comparison does not match translation unit comparison");
+
+    return differences;
 }
 
 @end
@@ -0,0 +1,200 @@
+#import <XCTest/XCTest.h>
+#import <ObjectDoc/ObjectDoc.h>
+#import "OCDAPISnapshot.h"
+
+@interface OCDAPISnapshotTests : XCTestCase
+@end
+
+@implementation OCDAPISnapshotTests
+
+- (void)testRoundTrip {
+    OCDAPISnapshot *snapshot = [self testSnapshot];
+    OCDAPISnapshot *loadedSnapshot = [OCDAPISnapshot snapshotWithData:[snapshot.data copy] error:NULL];
+    XCTAssertNotNil(loadedSnapshot);
+    XCTAssertEqualObjects(loadedSnapshot.baseDirectory, @"/tmp/api");
+    XCTAssertEqualObjects(loadedSnapshot.targetPlatformName, @"macos");
+    XCTAssertEqual(loadedSnapshot.recordCount, 2);
+
+    const OCDSnapshotRecord *record = &loadedSnapshot.records[0];
+    XCTAssertEqualObjects([loadedSnapshot stringForReference:record->key], @"c:objc(cs)Test(im)foo:");
+    XCTAssertEqualObjects([loadedSnapshot stringForReference:record->parentName], @"Test");
+    XCTAssertEqualObjects([loadedSnapshot displayNameForRecord:record], @"-[Test foo:]");
+    XCTAssertEqualObjects([loadedSnapshot stringForReference:record->path], @"test.h");
+    XCTAssertEqual(record->lineNumber, 3);
+    XCTAssertNil([loadedSnapshot stringForReference:record->deprecationMessage]);
+
+    NSUInteger count;
+    const OCDSnapshotStringRef *types = [loadedSnapshot elementsOfList:record->types count:&count];
+    XCTAssertEqual(count, 2);
+    XCTAssertEqualObjects([loadedSnapshot stringForReference:types[0]], @"void");
+    XCTAssertEqualObjects([loadedSnapshot stringForReference:types[1]], @"int");
+
+    [loadedSnapshot elementsOfList:record->protocols count:&count];
+    XCTAssertEqual(count, 0);
+}
+
+/**
+ * Tests that strings with embedded NUL characters and lists with nil elements are preserved.
+ */
+- (void)testNULAndNullElements {
+    OCDAPISnapshotBuilder *builder = [[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:@"/tmp/api" targetPlatformName:@"macos"];
+    NSString *spelling = [NSString stringWithFormat:@"a%Cb", (unichar)0];
+
+    OCDSnapshotRecord record;
+    memset(&record, 0xFF, sizeof(record));
+    record.key = [builder referenceForString:@"c:@F@Test"];
+    record.spelling = [builder referenceForString:spelling];
+    record.kind = PLClangCursorKindFunctionDeclaration;
+    record.flags = 0;
+    record.propertyAttributes = 0;
+    record.availabilityKind = PLClangAvailabilityKindAvailable;
+    record.types = [builder referenceForStrings:@[[NSNull null]]];
+    [builder addRecord:&record];
+
+    OCDAPISnapshot *snapshot = [OCDAPISnapshot snapshotWithData:[[builder snapshot].data copy] error:NULL];
+    XCTAssertNotNil(snapshot);
+    XCTAssertEqualObjects([snapshot stringForReference:snapshot.records[0].spelling], spelling);
+
+    NSUInteger count;
+    const OCDSnapshotStringRef *types = [snapshot elementsOfList:snapshot.records[0].types count:&count];
+    XCTAssertEqual(count, 1);
+    XCTAssertEqual(types[0], OCDSnapshotNullRef);
+
+    // A nil type is unequal to every type, so the record must always be compared
+    XCTAssertEqual(snapshot.records[0].fingerprint, OCDSnapshotNoFingerprint);
+}
+
+- (void)testStringsDeduplicated {
+    OCDAPISnapshot *snapshot = [self testSnapshot];
+    XCTAssertEqual(snapshot.records[0].path, snapshot.records[1].path);
+    XCTAssertEqual(snapshot.records[0].types, snapshot.records[1].types);
+    XCTAssertNotEqual(snapshot.records[0].key, snapshot.records[1].key);
+}
+
+- (void)testWriteToFile {
+    OCDAPISnapshot *snapshot = [self testSnapshot];
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    NSError *error;
+    XCTAssertTrue([snapshot writeToFile:path error:&error], @"%@", error);
+
+    OCDAPISnapshot *loadedSnapshot = [OCDAPISnapshot snapshotWithContentsOfFile:path error:&error];
+    XCTAssertNotNil(loadedSnapshot, @"%@", error);
+    XCTAssertEqualObjects(loadedSnapshot.data, snapshot.data);
+
+    [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+}
+
+- (void)testRejectsUnsupportedVersion {
+    NSMutableData *data = [[self testSnapshot].data mutableCopy];
+    uint32_t version = OCDAPISnapshotVersion + 1;
+    [data replaceBytesInRange:NSMakeRange(sizeof(uint32_t), sizeof(version)) withBytes:&version];
+
+    NSError *error;
+    XCTAssertNil([OCDAPISnapshot snapshotWithData:data error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void)testRejectsTruncatedData {
+    NSData *data = [self testSnapshot].data;
+    for (NSUInteger length = 0; length < [data length]; length += 7) {
+        NSError *error;
+        XCTAssertNil([OCDAPISnapshot snapshotWithData:[data subdataWithRange:NSMakeRange(0, length)] error:&error]);
+        XCTAssertNotNil(error);
+    }
+}
+
+- (void)testRejectsOutOfRangeReference {
+    NSMutableData *data = [[self testSnapshot].data mutableCopy];
+    OCDAPISnapshot *snapshot = [OCDAPISnapshot snapshotWithData:data error:NULL];
+    NSUInteger recordOffset = (const uint8_t *)snapshot.records - (const uint8_t *)snapshot.data.bytes;
+    OCDSnapshotStringRef reference = 0x7FFFFFF0;
+    [data replaceBytesInRange:NSMakeRange(recordOffset + offsetof(OCDSnapshotRecord, USR), sizeof(reference)) withBytes:&reference];
+
+    NSError *error;
+    XCTAssertNil([OCDAPISnapshot snapshotWithData:data error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+- (void)testFingerprints {
+    OCDAPISnapshot *snapshot = [self testSnapshot];
+    XCTAssertNotEqual(snapshot.records[0].fingerprint, OCDSnapshotNoFingerprint);
+    XCTAssertNotEqual(snapshot.records[0].fingerprint, snapshot.records[1].fingerprint);
+    XCTAssertEqual([self testSnapshot].records[0].fingerprint, snapshot.records[0].fingerprint);
+
+    // Values that are only reported, not compared, do not affect the fingerprint
+    OCDAPISnapshotBuilder *builder = [[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:@"/tmp/other" targetPlatformName:@"ios"];
+    OCDSnapshotRecord record = snapshot.records[0];
+    record.key = [builder referenceForString:@"c:objc(cs)Test(im)foo:"];
+    record.USR = record.key;
+    record.spelling = [builder referenceForString:@"foo:"];
+    record.parentName = [builder referenceForString:@"Test"];
+    record.declaration = [builder referenceForString:@"- (void)foo:(int)renamedValue"];
+    record.path = [builder referenceForString:@"moved.h"];
+    record.lineNumber = 10;
+    record.types = [builder referenceForStrings:@[@"void", @"int"]];
+    [builder addRecord:&record];
+
+    record.types = [builder referenceForStrings:@[@"void", @"long"]];
+    [builder addRecord:&record];
+
+    record.types = [builder referenceForStrings:@[@"void", @"int"]];
+    record.kind = PLClangCursorKindObjCPropertyDeclaration;
+    record.propertyAttributes = PLClangObjCPropertyAttributeGetter;
+    record.getterUSR = OCDSnapshotNullRef;
+    [builder addRecord:&record];
+
+    OCDAPISnapshot *otherSnapshot = [builder snapshot];
+    XCTAssertEqual(otherSnapshot.records[0].fingerprint, snapshot.records[0].fingerprint);
+    XCTAssertNotEqual(otherSnapshot.records[1].fingerprint, snapshot.records[0].fingerprint);
+    XCTAssertEqual(otherSnapshot.records[2].fingerprint, OCDSnapshotNoFingerprint);
+}
+
+- (void)testIdentifiersForStrings {
+    OCDAPISnapshot *snapshot = [self testSnapshot];
+    OCDStringTable *table = [[OCDStringTable alloc] init];
+    OCDStringID existingIdentifier = [table identifierForString:@"int"];
+    const OCDStringID *identifiers = [[snapshot identifiersForStringsInTable:table] bytes];
+
+    NSUInteger count;
+    const OCDSnapshotStringRef *types = [snapshot elementsOfList:snapshot.records[0].types count:&count];
+    XCTAssertEqual(identifiers[types[1] / sizeof(uint32_t)], existingIdentifier);
+    XCTAssertEqualObjects([table stringForIdentifier:identifiers[snapshot.records[0].key / sizeof(uint32_t)]], @"c:objc(cs)Test(im)foo:");
+    XCTAssertEqual(identifiers[snapshot.records[0].path / sizeof(uint32_t)], identifiers[snapshot.records[1].path / sizeof(uint32_t)]);
+
+    // Strings interned from a second snapshot share the identifiers of equal strings from the first
+    const OCDStringID *otherIdentifiers = [[[self testSnapshot] identifiersForStringsInTable:table] bytes];
+    XCTAssertEqual(otherIdentifiers[snapshot.records[1].key / sizeof(uint32_t)], identifiers[snapshot.records[1].key / sizeof(uint32_t)]);
+}
+
+- (OCDAPISnapshot *)testSnapshot {
+    OCDAPISnapshotBuilder *builder = [[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:@"/tmp/api" targetPlatformName:@"macos"];
+
+    OCDSnapshotRecord record;
+    memset(&record, 0xFF, sizeof(record));
+    record.key = [builder referenceForString:@"c:objc(cs)Test(im)foo:"];
+    record.USR = record.key;
+    record.spelling = [builder referenceForString:@"foo:"];
+    record.parentName = [builder referenceForString:@"Test"];
+    record.declaration = [builder referenceForString:@"- (void)foo:(int)value"];
+    record.path = [builder referenceForString:@"test.h"];
+    record.lineNumber = 3;
+    record.kind = PLClangCursorKindObjCInstanceMethodDeclaration;
+    record.flags = 0;
+    record.propertyAttributes = 0;
+    record.availabilityKind = PLClangAvailabilityKindAvailable;
+    record.types = [builder referenceForStrings:@[@"void", @"int"]];
+    [builder addRecord:&record];
+
+    record.key = [builder referenceForString:@"c:objc(cs)Test(im)bar:"];
+    record.USR = record.key;
+    record.spelling = [builder referenceForString:@"bar:"];
+    record.declaration = [builder referenceForString:@"- (void)bar:(int)value"];
+    record.path = [builder referenceForString:@"test.h"];
+    record.lineNumber = 4;
+    record.types = [builder referenceForStrings:@[@"void", @"int"]];
+    [builder addRecord:&record];
+
+    return [builder snapshot];
+}
+
+@end
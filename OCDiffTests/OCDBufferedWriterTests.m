@@ -0,0 +1,151 @@
+#import <XCTest/XCTest.h>
+#import "OCDBufferedWriter.h"
+
+@interface OCDBufferedWriterTests : XCTestCase
+@end
+
+@implementation OCDBufferedWriterTests {
+    NSString *_path;
+}
+
+- (void)setUp {
+    [super setUp];
+    _path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_path error:NULL];
+    [super tearDown];
+}
+
+- (NSString *)CFXMLEscapedString:(NSString *)string {
+    return CFBridgingRelease(CFXMLCreateStringByEscapingEntities(kCFAllocatorDefault, (__bridge CFStringRef)string, NULL));
+}
+
+- (NSString *)writerEscapedString:(NSString *)string {
+    OCDBufferedWriter *writer = [OCDBufferedWriter writerWithPath:_path error:NULL];
+    XCTAssertNotNil(writer);
+    [writer writeEscapedString:string];
+    XCTAssertTrue([writer close:NULL]);
+    return [NSString stringWithContentsOfFile:_path encoding:NSUTF8StringEncoding error:NULL];
+}
+
+/**
+ * Returns a declaration-like string of roughly the specified length with an occasional special character.
+ */
+- (NSString *)declarationTextWithLength:(NSUInteger)length {
+    NSMutableString *text = [NSMutableString string];
+    while ([text length] < length) {
+        [text appendString:@"- (NSArray<NSString *> *)valuesForKey:(NSString *)key options:(NSUInteger)options; "];
+        [text appendString:@"@property (nonatomic, copy, nullable) NSString *name; "];
+        [text appendString:@"#define TEST(a, b) ((a) && (b) ? \"yes\" : 'n') "];
+    }
+    return text;
+}
+
+- (void)testEscapingMatchesCFXML {
+    NSArray *strings = @[
+        @"",
+        @"a",
+        @"&",
+        @"<>&\"'",
+        @"- (void)test;",
+        @"- (NSArray<NSString *> *)test;",
+        @"12345678&",
+        @"1234567&8",
+        @"&12345678",
+        @"äöü <ß> \U0001F600 & ☃",
+        @"nothing special in this string at all, not even once",
+        [self declarationTextWithLength:200000],
+    ];
+
+    for (NSString *string in strings) {
+        XCTAssertEqualObjects([self writerEscapedString:string], [self CFXMLEscapedString:string]);
+    }
+}
+
+- (void)testFindXMLSpecialCharacter {
+    const char *text = "abcdefghijklmnopqrstuvwxyz";
+    size_t length = strlen(text);
+    XCTAssertEqual(OCDFindXMLSpecialCharacter((const uint8_t *)text, length), length);
+
+    const char *specials = "&<>\"'";
+    for (size_t s = 0; s < strlen(specials); s++) {
+        for (size_t i = 0; i < length; i++) {
+            char buffer[32];
+            memcpy(buffer, text, length);
+            buffer[i] = specials[s];
+            XCTAssertEqual(OCDFindXMLSpecialCharacter((const uint8_t *)buffer, length), i);
+        }
+    }
+
+    // Bytes adjacent to the special characters must not match
+    const char *neighbors = "%;=?!#(%;=?!#(";
+    XCTAssertEqual(OCDFindXMLSpecialCharacter((const uint8_t *)neighbors, strlen(neighbors)), strlen(neighbors));
+}
+
+- (void)testWriteStrings {
+    OCDBufferedWriter *writer = [OCDBufferedWriter writerWithPath:_path error:NULL];
+    XCTAssertNotNil(writer);
+
+    NSString *longText = [self declarationTextWithLength:100000];
+    [writer writeUTF8String:"<p>"];
+    [writer writeString:@"Café <b>"];
+    [writer writeString:longText];
+    [writer writeEscapedString:@"</p>"];
+    XCTAssertTrue([writer close:NULL]);
+
+    NSString *expected = [NSString stringWithFormat:@"<p>Café <b>%@&lt;/p&gt;", longText];
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:_path encoding:NSUTF8StringEncoding error:NULL], expected);
+}
+
+- (void)testWriteStringsWithNULAndNil {
+    OCDBufferedWriter *writer = [OCDBufferedWriter writerWithPath:_path error:NULL];
+    XCTAssertNotNil(writer);
+
+    NSString *string = [NSString stringWithFormat:@"a%Cb", (unichar)0];
+    NSString *nilString = nil;
+    [writer writeString:string];
+    [writer writeString:@"ä"];
+    [writer writeEscapedString:string];
+    [writer writeString:nilString];
+    XCTAssertTrue([writer close:NULL]);
+
+    NSString *expected = [NSString stringWithFormat:@"%@ä%@%@", string, string, nilString];
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:_path encoding:NSUTF8StringEncoding error:NULL], expected);
+}
+
+- (void)testInvalidPath {
+    NSError *error;
+    NSString *path = [_path stringByAppendingPathComponent:@"missing/file.html"];
+    XCTAssertNil([OCDBufferedWriter writerWithPath:path error:&error]);
+    XCTAssertEqualObjects(error.domain, NSPOSIXErrorDomain);
+}
+
+/**
+ * Measures escaping a large report's worth of declarations with CFXMLCreateStringByEscapingEntities and writing the
+ * results, for comparison with testEscapingPerformance.
+ */
+- (void)testCFXMLEscapingPerformance {
+    NSString *text = [self declarationTextWithLength:200];
+    [self measureBlock:^{
+        NSMutableString *html = [NSMutableString string];
+        for (NSUInteger i = 0; i < 20000; i++) {
+            [html appendString:[self CFXMLEscapedString:text]];
+        }
+        [html writeToFile:self->_path atomically:NO encoding:NSUTF8StringEncoding error:NULL];
+    }];
+}
+
+- (void)testEscapingPerformance {
+    NSString *text = [self declarationTextWithLength:200];
+    [self measureBlock:^{
+        OCDBufferedWriter *writer = [OCDBufferedWriter writerWithPath:self->_path error:NULL];
+        for (NSUInteger i = 0; i < 20000; i++) {
+            [writer writeEscapedString:text];
+        }
+        [writer close:NULL];
+    }];
+}
+
+@end
@@ -0,0 +1,87 @@
+#import <XCTest/XCTest.h>
+#import "OCDCache.h"
+
+@interface OCDCacheTests : XCTestCase
+@end
+
+@implementation OCDCacheTests {
+    NSString *_directory;
+}
+
+- (void)setUp {
+    [super setUp];
+    _directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:NULL];
+    [super tearDown];
+}
+
+- (void)testKeyIsDeterministic {
+    NSString *key = [OCDCache keyForComponents:@[@"a", @"b"]];
+    XCTAssertEqualObjects(key, [OCDCache keyForComponents:@[@"a", @"b"]]);
+    XCTAssertEqual([key length], 64);
+}
+
+- (void)testKeyDistinguishesComponentBoundaries {
+    XCTAssertNotEqualObjects([OCDCache keyForComponents:@[@"ab", @"c"]], [OCDCache keyForComponents:@[@"a", @"bc"]]);
+    XCTAssertNotEqualObjects([OCDCache keyForComponents:@[@"a", @"b"]], [OCDCache keyForComponents:@[@"b", @"a"]]);
+}
+
+- (void)testStoreData {
+    NSError *error;
+    OCDCache *cache = [OCDCache cacheWithDirectory:_directory error:&error];
+    XCTAssertNotNil(cache, @"%@", error);
+
+    NSString *key = [OCDCache keyForComponents:@[@"test"]];
+    XCTAssertNil([cache pathForKey:key extension:@"dat"]);
+
+    NSData *data = [@"contents" dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *path = [cache storeData:data forKey:key extension:@"dat" error:&error];
+    XCTAssertNotNil(path, @"%@", error);
+    XCTAssertEqualObjects([cache pathForKey:key extension:@"dat"], path);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], data);
+    XCTAssertNil([cache pathForKey:key extension:@"pch"]);
+}
+
+- (void)testStoreReplacesExistingEntry {
+    OCDCache *cache = [OCDCache cacheWithDirectory:_directory error:NULL];
+    NSString *key = [OCDCache keyForComponents:@[@"test"]];
+    NSData *data = [@"new" dataUsingEncoding:NSUTF8StringEncoding];
+
+    [cache storeData:[@"old" dataUsingEncoding:NSUTF8StringEncoding] forKey:key extension:@"dat" error:NULL];
+    NSString *path = [cache storeData:data forKey:key extension:@"dat" error:NULL];
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], data);
+
+    // No temporary files are left behind
+    NSArray *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtPath:_directory error:NULL];
+    XCTAssertEqualObjects(contents, @[[path lastPathComponent]]);
+}
+
+- (void)testStoreFile {
+    OCDCache *cache = [OCDCache cacheWithDirectory:_directory error:NULL];
+    NSString *key = [OCDCache keyForComponents:@[@"test"]];
+    NSData *data = [@"contents" dataUsingEncoding:NSUTF8StringEncoding];
+    NSString *sourcePath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [data writeToFile:sourcePath atomically:NO];
+
+    NSError *error;
+    NSString *path = [cache storeFileAtPath:sourcePath forKey:key extension:@"pch" error:&error];
+    XCTAssertNotNil(path, @"%@", error);
+    XCTAssertEqualObjects([NSData dataWithContentsOfFile:path], data);
+    XCTAssertTrue([[NSFileManager defaultManager] fileExistsAtPath:sourcePath]);
+
+    [[NSFileManager defaultManager] removeItemAtPath:sourcePath error:NULL];
+}
+
+- (void)testRemoveEntry {
+    OCDCache *cache = [OCDCache cacheWithDirectory:_directory error:NULL];
+    NSString *key = [OCDCache keyForComponents:@[@"test"]];
+    [cache storeData:[NSData data] forKey:key extension:@"dat" error:NULL];
+
+    [cache removeEntryForKey:key extension:@"dat"];
+    XCTAssertNil([cache pathForKey:key extension:@"dat"]);
+}
+
+@end
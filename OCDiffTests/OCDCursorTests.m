@@ -0,0 +1,76 @@
+#import <XCTest/XCTest.h>
+#import <ObjectDoc/ObjectDoc.h>
+#import "OCDCursor.h"
+
+@interface OCDCursorTests : XCTestCase
+@end
+
+@implementation OCDCursorTests
+
+- (void)testMemoizedProperties {
+    PLClangCursor *functionCursor = [self cursorForFunctionInSource:@"void Test(void) __attribute__((deprecated));"];
+    XCTAssertNotNil(functionCursor);
+
+    OCDCursor *cursor = [OCDCursor cursorWithCursor:functionCursor];
+    XCTAssertEqual(cursor.cursor, functionCursor);
+    XCTAssertEqual(cursor.kind, PLClangCursorKindFunctionDeclaration);
+    XCTAssertEqualObjects(cursor.spelling, @"Test");
+    XCTAssertEqualObjects(cursor.USR, functionCursor.USR);
+    XCTAssertEqualObjects(cursor.path, functionCursor.location.path);
+    XCTAssertEqualObjects([cursor.path lastPathComponent], @"test.h");
+    XCTAssertEqual(cursor.location.lineNumber, 1);
+    XCTAssertEqual(cursor.availability.kind, PLClangAvailabilityKindDeprecated);
+    XCTAssertEqualObjects(cursor.canonicalCursor, functionCursor);
+    XCTAssertTrue(cursor.isDeclaration);
+    XCTAssertFalse(cursor.isImplicit);
+
+    // Repeated reads return the memoized objects
+    XCTAssertEqual(cursor.spelling, cursor.spelling);
+    XCTAssertEqual(cursor.location, cursor.location);
+}
+
+- (void)testStatistics {
+    OCDCursor *cursor = [OCDCursor cursorWithCursor:[self cursorForFunctionInSource:@"void Test(void);"]];
+
+    [OCDCursor setCollectsStatistics:YES];
+    uint64_t hitCount = [OCDCursor hitCountForProperty:OCDCursorPropertySpelling];
+    uint64_t missCount = [OCDCursor missCountForProperty:OCDCursorPropertySpelling];
+
+    for (NSUInteger i = 0; i < 3; i++) {
+        XCTAssertEqualObjects(cursor.spelling, @"Test");
+    }
+
+    XCTAssertEqual([OCDCursor hitCountForProperty:OCDCursorPropertySpelling] - hitCount, 2);
+    XCTAssertEqual([OCDCursor missCountForProperty:OCDCursorPropertySpelling] - missCount, 1);
+
+    [OCDCursor setCollectsStatistics:NO];
+    (void)cursor.spelling;
+    XCTAssertEqual([OCDCursor hitCountForProperty:OCDCursorPropertySpelling] - hitCount, 2);
+}
+
+- (PLClangCursor *)cursorForFunctionInSource:(NSString *)source {
+    PLClangSourceIndex *index = [PLClangSourceIndex indexWithOptions:0];
+    PLClangUnsavedFile *file = [PLClangUnsavedFile unsavedFileWithPath:@"test.h" data:[source dataUsingEncoding:NSUTF8StringEncoding]];
+
+    NSError *error;
+    PLClangTranslationUnit *translationUnit = [index addTranslationUnitWithSourcePath:@"test.h"
+                                                                         unsavedFiles:@[file]
+                                                                    compilerArguments:@[@"-x", @"objective-c-header"]
+                                                                              options:PLClangTranslationUnitCreationSkipFunctionBodies
+                                                                                error:&error];
+    XCTAssertNotNil(translationUnit, @"Failed to parse: %@", error);
+
+    __block PLClangCursor *functionCursor = nil;
+    [translationUnit.cursor visitChildrenUsingBlock:^PLClangCursorVisitResult(PLClangCursor *cursor) {
+        if (cursor.kind == PLClangCursorKindFunctionDeclaration && [cursor.spelling isEqualToString:@"Test"]) {
+            functionCursor = cursor;
+            return PLClangCursorVisitBreak;
+        }
+
+        return PLClangCursorVisitContinue;
+    }];
+
+    return functionCursor;
+}
+
+@end
@@ -0,0 +1,39 @@
+#import <XCTest/XCTest.h>
+#import "OCDHash.h"
+
+@interface OCDHashTests : XCTestCase
+@end
+
+@implementation OCDHashTests
+
+- (uint64_t)hashOfString:(const char *)string seed:(uint64_t)seed {
+    return OCDHash64(string, strlen(string), seed);
+}
+
+- (void)testKnownValues {
+    // Reference values for XXH64
+    XCTAssertEqual([self hashOfString:"" seed:0], 0xEF46DB3751D8E999ULL);
+    XCTAssertEqual([self hashOfString:"a" seed:0], 0xD24EC4F1A98C6E5BULL);
+    XCTAssertEqual([self hashOfString:"abc" seed:0], 0x44BC2CF5AD770999ULL);
+    XCTAssertEqual([self hashOfString:"Nobody inspects the spammish repetition" seed:0], 0xFBCEA83C8A378BF1ULL);
+}
+
+- (void)testSeed {
+    XCTAssertNotEqual([self hashOfString:"abc" seed:0], [self hashOfString:"abc" seed:1]);
+}
+
+- (void)testSingleByteChange {
+    NSMutableData *data = [NSMutableData dataWithLength:4096];
+    uint64_t hash = OCDHash64([data bytes], [data length], 0);
+
+    for (NSUInteger offset = 0; offset < [data length]; offset += 509) {
+        uint8_t *bytes = [data mutableBytes];
+        bytes[offset] = 1;
+        XCTAssertNotEqual(OCDHash64([data bytes], [data length], 0), hash, @"offset %lu", (unsigned long)offset);
+        bytes[offset] = 0;
+    }
+
+    XCTAssertEqual(OCDHash64([data bytes], [data length], 0), hash);
+}
+
+@end
@@ -0,0 +1,73 @@
+#import <XCTest/XCTest.h>
+#import "OCDParseCache.h"
+
+@interface OCDParseCacheTests : XCTestCase
+@end
+
+@implementation OCDParseCacheTests {
+    NSString *_directory;
+    NSString *_headerPath;
+}
+
+- (void)setUp {
+    [super setUp];
+    _directory = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+    [[NSFileManager defaultManager] createDirectoryAtPath:_directory withIntermediateDirectories:YES attributes:nil error:NULL];
+
+    _headerPath = [_directory stringByAppendingPathComponent:@"Test.h"];
+    [@"void foo(void);\n" writeToFile:_headerPath atomically:NO encoding:NSUTF8StringEncoding error:NULL];
+}
+
+- (void)tearDown {
+    [[NSFileManager defaultManager] removeItemAtPath:_directory error:NULL];
+    [super tearDown];
+}
+
+- (NSString *)keyWithSource:(NSString *)source arguments:(NSArray *)arguments {
+    return [OCDParseCache keyForSource:source headerPaths:@[_headerPath] compilerArguments:arguments SDK:nil];
+}
+
+- (void)testKeyReflectsInputs {
+    NSString *key = [self keyWithSource:@"#import \"Test.h\"\n" arguments:@[@"-x", @"objective-c-header"]];
+    XCTAssertNotNil(key);
+    XCTAssertEqualObjects(key, [self keyWithSource:@"#import \"Test.h\"\n" arguments:@[@"-x", @"objective-c-header"]]);
+    XCTAssertNotEqualObjects(key, [self keyWithSource:@"#include \"Test.h\"\n" arguments:@[@"-x", @"objective-c-header"]]);
+    XCTAssertNotEqualObjects(key, [self keyWithSource:@"#import \"Test.h\"\n" arguments:@[@"-x", @"objective-c-header", @"-DTEST"]]);
+
+    [@"void bar(void);\n" writeToFile:_headerPath atomically:NO encoding:NSUTF8StringEncoding error:NULL];
+    XCTAssertNotEqualObjects(key, [self keyWithSource:@"#import \"Test.h\"\n" arguments:@[@"-x", @"objective-c-header"]]);
+}
+
+- (void)testKeyForMissingHeader {
+    NSString *missingPath = [_directory stringByAppendingPathComponent:@"Missing.h"];
+    XCTAssertNil([OCDParseCache keyForSource:@"" headerPaths:@[missingPath] compilerArguments:@[] SDK:nil]);
+}
+
+- (void)testHitAndMiss {
+    OCDParseCache *parseCache = [[OCDParseCache alloc] initWithCache:[OCDCache cacheWithDirectory:[_directory stringByAppendingPathComponent:@"Cache"] error:NULL]];
+    NSString *key = [self keyWithSource:@"" arguments:@[]];
+    XCTAssertNil([parseCache snapshotForKey:key]);
+
+    OCDAPISnapshot *snapshot = [[[OCDAPISnapshotBuilder alloc] initWithBaseDirectory:_directory targetPlatformName:@"macos"] snapshot];
+    NSError *error;
+    XCTAssertTrue([parseCache storeSnapshot:snapshot forKey:key error:&error], @"%@", error);
+
+    OCDAPISnapshot *cachedSnapshot = [parseCache snapshotForKey:key];
+    XCTAssertNotNil(cachedSnapshot);
+    XCTAssertEqualObjects(cachedSnapshot.baseDirectory, _directory);
+    XCTAssertEqual(parseCache.hitCount, 1);
+    XCTAssertEqual(parseCache.missCount, 1);
+}
+
+- (void)testCorruptEntryIsDiscarded {
+    OCDCache *cache = [OCDCache cacheWithDirectory:[_directory stringByAppendingPathComponent:@"Cache"] error:NULL];
+    OCDParseCache *parseCache = [[OCDParseCache alloc] initWithCache:cache];
+    NSString *key = [self keyWithSource:@"" arguments:@[]];
+    [cache storeData:[@"corrupt" dataUsingEncoding:NSUTF8StringEncoding] forKey:key extension:@"ocdsnapshot" error:NULL];
+
+    XCTAssertNil([parseCache snapshotForKey:key]);
+    XCTAssertNil([cache pathForKey:key extension:@"ocdsnapshot"]);
+    XCTAssertEqual(parseCache.missCount, 1);
+}
+
+@end
@@ -0,0 +1,58 @@
+#import <XCTest/XCTest.h>
+#import "OCDSDKManifest.h"
+
+@interface OCDSDKManifestTests : XCTestCase
+@end
+
+@implementation OCDSDKManifestTests
+
+- (OCDModule *)testModule {
+    OCDModification *modification = [OCDModification modificationWithType:OCDModificationTypeDeclaration
+                                                             previousValue:@"- (void)foo"
+                                                              currentValue:@"- (void)foo:(int)value"];
+    NSArray *differences = @[
+        [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"Bar" path:@"Test.h" lineNumber:3 USR:@"c:objc(cs)Bar"],
+        [OCDifference modificationDifferenceWithName:@"-[Test foo]" path:@"Test.h" lineNumber:5 modifications:@[modification]]
+    ];
+
+    return [OCDModule moduleWithName:@"Test" differenceType:OCDifferenceTypeModification differences:differences];
+}
+
+- (void)testRoundTrip {
+    OCDSDKManifest *manifest = [[OCDSDKManifest alloc] init];
+    NSDictionary *inputs = @{@"arguments": @"a", @"new:Test.framework": @"b"};
+    OCDModule *module = [self testModule];
+    [manifest setModule:module inputs:inputs forFramework:@"Test.framework"];
+
+    NSError *error;
+    OCDSDKManifest *loadedManifest = [OCDSDKManifest manifestWithData:[manifest data] error:&error];
+    XCTAssertNotNil(loadedManifest, @"%@", error);
+    XCTAssertEqual(loadedManifest.frameworkCount, 1);
+    XCTAssertTrue([loadedManifest hasModuleForFramework:@"Test.framework" inputs:inputs]);
+
+    OCDModule *loadedModule = [loadedManifest moduleForFramework:@"Test.framework" inputs:inputs];
+    XCTAssertEqualObjects(loadedModule.name, module.name);
+    XCTAssertEqual(loadedModule.differenceType, module.differenceType);
+    XCTAssertEqualObjects(loadedModule.differences, module.differences);
+}
+
+- (void)testChangedInputs {
+    OCDSDKManifest *manifest = [[OCDSDKManifest alloc] init];
+    [manifest setModule:[self testModule] inputs:@{@"new:Test.framework": @"b"} forFramework:@"Test.framework"];
+
+    XCTAssertNil([manifest moduleForFramework:@"Test.framework" inputs:@{@"new:Test.framework": @"c"}]);
+    XCTAssertNil([manifest moduleForFramework:@"Test.framework" inputs:@{@"new:Test.framework": @"b", @"new:Other.framework": @"d"}]);
+    XCTAssertNil([manifest moduleForFramework:@"Other.framework" inputs:@{@"new:Test.framework": @"b"}]);
+
+    XCTAssertTrue([manifest hasModuleForFramework:@"Test.framework" inputs:@{@"new:Test.framework": @"b"}]);
+    XCTAssertFalse([manifest hasModuleForFramework:@"Test.framework" inputs:@{@"new:Test.framework": @"c"}]);
+    XCTAssertFalse([manifest hasModuleForFramework:@"Other.framework" inputs:@{@"new:Test.framework": @"b"}]);
+}
+
+- (void)testRejectsCorruptData {
+    NSError *error;
+    XCTAssertNil([OCDSDKManifest manifestWithData:[@"corrupt" dataUsingEncoding:NSUTF8StringEncoding] error:&error]);
+    XCTAssertEqual(error.code, NSFileReadCorruptFileError);
+}
+
+@end
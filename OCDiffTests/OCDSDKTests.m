@@ -95,6 +95,33 @@
     XCTAssertNil(sdk.defaultArchitecture);
 }
 
+- (NSArray *)defaultCompilerArgumentsForSDK:(OCDSDK *)sdk {
+    return @[
+        @"-isysroot", sdk.path,
+        [NSString stringWithFormat:@"%@=%@", sdk.deploymentTargetCompilerArgument, sdk.deploymentTarget],
+        [NSString stringWithFormat:@"-DAPI_TO_BE_DEPRECATED=%@", sdk.deploymentTarget],
+        [NSString stringWithFormat:@"-F%@/System/Library/PrivateFrameworks", sdk.path]
+    ];
+}
+
+- (void)testCompilerArgumentsIndependentOfSDK {
+    OCDSDK *oldSDK = [[OCDSDK alloc] initWithPath:[_sdksDir stringByAppendingPathComponent:@"MacOSX10.9.sdk"]];
+    OCDSDK *newSDK = [[OCDSDK alloc] initWithPath:[_sdksDir stringByAppendingPathComponent:@"MacOSX10.13.sdk"]];
+
+    // The default deployment targets of SDKs of different versions differ and may change the parsed API, so their
+    // arguments do not match
+    NSArray *oldArguments = [oldSDK compilerArgumentsIndependentOfSDK:[self defaultCompilerArgumentsForSDK:oldSDK]];
+    NSArray *newArguments = [newSDK compilerArgumentsIndependentOfSDK:[self defaultCompilerArgumentsForSDK:newSDK]];
+    XCTAssertEqualObjects(oldArguments, (@[@"-isysroot", @"$(SDKROOT)", @"-mmacosx-version-min=10.9", @"-DAPI_TO_BE_DEPRECATED=10.9", @"-F$(SDKROOT)/System/Library/PrivateFrameworks"]));
+    XCTAssertNotEqualObjects(oldArguments, newArguments);
+
+    // With an explicitly specified deployment target only the SDK paths differ
+    NSArray *explicitArguments = @[@"-mmacosx-version-min=10.9"];
+    oldArguments = [oldSDK compilerArgumentsIndependentOfSDK:[@[@"-isysroot", oldSDK.path] arrayByAddingObjectsFromArray:explicitArguments]];
+    newArguments = [newSDK compilerArgumentsIndependentOfSDK:[@[@"-isysroot", newSDK.path] arrayByAddingObjectsFromArray:explicitArguments]];
+    XCTAssertEqualObjects(oldArguments, newArguments);
+}
+
 - (void)testIOS {
     NSString *path = [_sdksDir stringByAppendingPathComponent:@"iPhoneOS7.0.sdk"];
     OCDSDK *sdk = [[OCDSDK alloc] initWithPath:path];
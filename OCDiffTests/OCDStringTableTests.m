@@ -0,0 +1,47 @@
+#import <XCTest/XCTest.h>
+#import "OCDStringTable.h"
+
+@interface OCDStringTableTests : XCTestCase
+@end
+
+@implementation OCDStringTableTests
+
+- (void)testIdentifiers {
+    OCDStringTable *table = [[OCDStringTable alloc] init];
+    OCDStringID foo = [table identifierForString:@"foo"];
+    OCDStringID bar = [table identifierForString:@"bar"];
+
+    XCTAssertEqual(foo, 0);
+    XCTAssertEqual(bar, 1);
+    XCTAssertEqual([table identifierForString:@"foo"], foo);
+    XCTAssertEqual([table identifierForUTF8String:"barbaz" length:3], bar);
+    XCTAssertEqual(table.count, 2);
+
+    XCTAssertEqualObjects([table stringForIdentifier:foo], @"foo");
+    XCTAssertEqualObjects([table stringForIdentifier:bar], @"bar");
+}
+
+- (void)testEmptyString {
+    OCDStringTable *table = [[OCDStringTable alloc] init];
+    OCDStringID empty = [table identifierForString:@""];
+
+    XCTAssertEqual([table identifierForUTF8String:"" length:0], empty);
+    XCTAssertEqualObjects([table stringForIdentifier:empty], @"");
+}
+
+- (void)testGrowth {
+    OCDStringTable *table = [[OCDStringTable alloc] init];
+    for (NSUInteger i = 0; i < 10000; i++) {
+        XCTAssertEqual([table identifierForString:[NSString stringWithFormat:@"c:@F@Function%lu", (unsigned long)i]], i);
+    }
+
+    XCTAssertEqual(table.count, 10000);
+
+    for (NSUInteger i = 0; i < 10000; i += 97) {
+        NSString *string = [NSString stringWithFormat:@"c:@F@Function%lu", (unsigned long)i];
+        XCTAssertEqual([table identifierForString:string], i);
+        XCTAssertEqualObjects([table stringForIdentifier:(OCDStringID)i], string);
+    }
+}
+
+@end
@@ -0,0 +1,104 @@
+#import <XCTest/XCTest.h>
+#import "OCDifference.h"
+
+@interface OCDifferenceTests : XCTestCase
+@end
+
+/**
+ * Compares two differences in report order directly, as a reference for +[OCDifference sortDifferences:].
+ */
+static NSComparisonResult OCDCompareDifferences(OCDifference *difference1, OCDifference *difference2) {
+    NSComparisonResult result = [difference1.path localizedStandardCompare:difference2.path];
+    if (result != NSOrderedSame)
+        return result;
+
+    if (difference1.type != difference2.type)
+        return difference1.type < difference2.type ? NSOrderedAscending : NSOrderedDescending;
+
+    if (difference1.lineNumber != difference2.lineNumber)
+        return difference1.lineNumber < difference2.lineNumber ? NSOrderedAscending : NSOrderedDescending;
+
+    return [difference1.name caseInsensitiveCompare:difference2.name];
+}
+
+@implementation OCDifferenceTests
+
+/**
+ * Tests that sorting differences produces the same order as a stable sort comparing differences directly.
+ */
+- (void)testSortDifferencesMatchesStableSort {
+    NSArray *paths = @[@"Test.h", @"test.h", @"Test2.h", @"Test10.h", @"A/B.h", @"A-B.h", @"A_B.h", @"Ärger.h"];
+    NSArray *names = @[@"b", @"B", @"a", @"-[Test b]", @"+[Test a]", @"Test.b", @"_a", @"ä"];
+
+    NSMutableArray *differences = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 500; i++) {
+        NSString *path = paths[(i * 7) % [paths count]];
+        NSString *name = names[(i * 5) % [names count]];
+        OCDifferenceType type = (OCDifferenceType)(i % 3);
+        NSUInteger lineNumber = (i * 11) % 4;
+        [differences addObject:[OCDifference differenceWithType:type name:name path:path lineNumber:lineNumber]];
+    }
+
+    NSMutableArray *expected = [differences mutableCopy];
+    [expected sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(OCDifference *difference1, OCDifference *difference2) {
+        return OCDCompareDifferences(difference1, difference2);
+    }];
+
+    [OCDifference sortDifferences:differences];
+
+    XCTAssertEqual([differences count], [expected count]);
+    for (NSUInteger i = 1; i < [differences count]; i++) {
+        XCTAssertNotEqual(OCDCompareDifferences(differences[i - 1], differences[i]), NSOrderedDescending, @"Differences out of order at index %lu", (unsigned long)i);
+    }
+
+    XCTAssertEqualObjects(differences, expected);
+}
+
+/**
+ * Tests that differences in distinct paths that compare as equal are ordered by line number.
+ */
+- (void)testSortDifferencesWithEquivalentPaths {
+    NSString *composedPath = @"Ärger.h";
+    NSString *decomposedPath = @"A\u0308rger.h";
+    XCTAssertEqual([composedPath localizedStandardCompare:decomposedPath], NSOrderedSame);
+
+    OCDifference *first = [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"a" path:decomposedPath lineNumber:1];
+    OCDifference *second = [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"b" path:composedPath lineNumber:2];
+    OCDifference *third = [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"c" path:decomposedPath lineNumber:3];
+    OCDifference *fourth = [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"c" path:composedPath lineNumber:3];
+
+    NSMutableArray *differences = [@[fourth, second, third, first] mutableCopy];
+    [OCDifference sortDifferences:differences];
+
+    // Equal differences keep their original order
+    NSArray *expected = @[first, second, fourth, third];
+    XCTAssertEqualObjects(differences, expected);
+}
+
+- (void)testNameBlock {
+    __block NSUInteger callCount = 0;
+    OCDifference *difference = [OCDifference differenceWithType:OCDifferenceTypeAddition
+                                                      nameBlock:^{
+                                                          callCount++;
+                                                          return @"Test()";
+                                                      }
+                                                           path:@"test.h"
+                                                     lineNumber:1
+                                                            USR:nil
+                                                  modifications:nil];
+    XCTAssertEqual(callCount, 0);
+
+    XCTAssertEqualObjects(difference.name, @"Test()");
+    XCTAssertEqualObjects(difference.name, @"Test()");
+    XCTAssertEqual(callCount, 1);
+
+    XCTAssertEqualObjects(difference, [OCDifference differenceWithType:OCDifferenceTypeAddition name:@"Test()" path:@"test.h" lineNumber:1]);
+}
+
+- (void)testSortEmptyDifferences {
+    NSMutableArray *differences = [NSMutableArray array];
+    [OCDifference sortDifferences:differences];
+    XCTAssertEqualObjects(differences, @[]);
+}
+
+@end